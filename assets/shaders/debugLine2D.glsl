@@ -5,8 +5,12 @@ layout (location = 1) in vec3 aColor;
 
 out vec3 fColor;
 
-uniform mat4 uView;
-uniform mat4 uProjection;
+layout (std140) uniform Camera {
+    mat4 uProjection;
+    mat4 uView;
+    mat4 uInvProjection;
+    mat4 uInvView;
+};
 
 void main()
 {
@@ -0,0 +1,31 @@
+#type vertex
+#version 330 core
+
+layout (location = 0) in vec2 aPos; // already in the layer's normalized device coordinates
+layout (location = 1) in vec2 aTexCoords;
+layout (location = 2) in vec4 aColor;
+
+out vec4 fColor;
+out vec2 fTexCoords;
+
+void main() {
+    fColor = aColor;
+    fTexCoords = aTexCoords;
+    gl_Position = vec4(aPos, 0.0, 1.0);
+}
+
+#type fragment
+#version 330 core
+
+uniform sampler2D uTexture;
+uniform int uTextured;
+
+in vec4 fColor;
+in vec2 fTexCoords;
+
+out vec4 FragColor;
+
+void main() {
+    FragColor = uTextured != 0 ? fColor * texture(uTexture, fTexCoords) : fColor;
+    FragColor.rgb *= FragColor.a; // the layer stores premultiplied color
+}
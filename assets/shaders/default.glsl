@@ -5,40 +5,134 @@ layout (location = 0) in vec2 aPos;
 layout (location = 1) in vec4 aColor;
 layout (location = 2) in vec2 aTexCoords;
 layout (location = 3) in float aTexId;
+layout (location = 5) in vec3 aAnim; // clip ID, start time, playback rate
+layout (location = 6) in float aMaterial;
 
-uniform mat4 uProjection;
-uniform mat4 uView;
+layout (std140) uniform Camera {
+    mat4 uProjection;
+    mat4 uView;
+    mat4 uInvProjection;
+    mat4 uInvView;
+};
+uniform float uTime;
+uniform samplerBuffer uClips;
+uniform samplerBuffer uFrames;
+uniform samplerBuffer uMaterials; // 3 texels per material -- tint, flash color and amount, palette row and blend mode
+uniform vec2 uScrollLag; // 1 - the layer's scroll factor (0 = moves with the world)
+uniform vec2 uRepeat; // distance the layer repeats after (0 = does not repeat)
+uniform vec2 uRepeatCopy; // which copy of a repeating layer is being drawn
 
 out vec4 fColor;
 out vec2 fTextCoords;
 out float fTexId;
+flat out vec4 fFlash;
+flat out vec2 fPaletteBlend;
+out vec2 fWorldPos;
+
+// Pick the current frame's texture coordinates out of the clip table.
+vec2 animTexCoords() {
+    vec4 clip = texelFetch(uClips, int(aAnim.x)); // first frame, frame count, fps, loop
+    int frame = int(floor(max(uTime - aAnim.y, 0.0) * aAnim.z * clip.z));
+    frame = clip.w > 0.5 ? frame % int(clip.y) : min(frame, int(clip.y) - 1);
+
+    vec4 rect = texelFetch(uFrames, int(clip.x) + frame); // left, bottom, right, top
+
+    // the corners of each quad are ordered top right, bottom right, bottom left, top left
+    int corner = gl_VertexID & 3;
+    return vec2(corner < 2 ? rect.z : rect.x, (corner == 0 || corner == 3) ? rect.w : rect.y);
+}
+
+// Where the sprite's layer is moved to by its parallax (see Parallax in render.h).
+// The camera sits at the translation of the inverse view.
+vec2 layerOffset() {
+    vec2 camera = uInvView[3].xy;
+    vec2 offset = camera * uScrollLag;
+
+    // move a repeating layer by whole periods so its first copy starts at or before the camera (the second copy covers the rest)
+    if (uRepeat.x > 0.0) { offset.x += (floor((camera.x - offset.x) / uRepeat.x) + uRepeatCopy.x) * uRepeat.x; }
+    if (uRepeat.y > 0.0) { offset.y += (floor((camera.y - offset.y) / uRepeat.y) + uRepeatCopy.y) * uRepeat.y; }
+    return offset;
+}
 
 void main() {
-    fColor = aColor;
-    fTextCoords = aTexCoords;
+    int material = 3 * int(aMaterial);
+
+    fColor = aColor * texelFetch(uMaterials, material);
+    fFlash = texelFetch(uMaterials, material + 1);
+    fPaletteBlend = texelFetch(uMaterials, material + 2).xy;
+    fTextCoords = aAnim.x < 0.0 ? aTexCoords : animTexCoords();
     fTexId = aTexId;
-    gl_Position = uProjection * uView * vec4(aPos, 0.0, 1.0);
+    fWorldPos = aPos + layerOffset();
+    gl_Position = uProjection * uView * vec4(fWorldPos, 0.0, 1.0);
 }
 
 #type fragment
 #version 330 core
 
 uniform sampler2D uTexture[16]; // todo at some point use openGL to get the total number of slots available
+uniform sampler2D uLightMap; // light reaching each pixel of the scene (at a lower resolution)
+uniform vec2 uSceneSize;
+uniform int uLighting;
+uniform sampler2D uPalette; // each row is a palette indexed by a texel's red channel
+uniform int uPaletteRows; // 0 = no palette
+uniform int uFog;
+uniform sampler2D uDiscovery; // 1 where the active room's map has been revealed
+uniform vec2 uFogOrigin; // world region the map covers
+uniform vec2 uFogSize;
+uniform vec3 uFogColor;
 
 in vec4 fColor;
 in vec2 fTextCoords;
 in float fTexId;
+flat in vec4 fFlash;
+flat in vec2 fPaletteBlend; // palette row (-1 = none), blend mode (0 = alpha, 1 = additive)
+in vec2 fWorldPos;
 
 out vec4 FragColor;
 
 void main() {
-    if (fTexId >= 0) {
+    if (fTexId >= 32) {
+        // premultiplied texture (a decal layer) -- undo it so the tint and the premultiply below treat it like any other sprite
+        vec4 texel = texture(uTexture[int(fTexId) - 32], fTextCoords);
+        if (texel.a > 0.0) { texel.rgb /= texel.a; }
+        FragColor = fColor * texel;
+
+    } else if (fTexId >= 16) {
+        // signed distance field (text) -- the glyph's edge sits at 0.5 and fwidth keeps it about a pixel wide at any scale
+        float dist = texture(uTexture[int(fTexId) - 16], fTextCoords).a;
+        float edge = fwidth(dist);
+        FragColor = vec4(fColor.rgb, fColor.a * smoothstep(0.5 - edge, 0.5 + edge, dist));
+
+    } else if (fTexId >= 0) {
         int id  = int (fTexId);
-        FragColor = fColor * texture(uTexture[id], fTextCoords);
+        vec4 texel = texture(uTexture[id], fTextCoords);
+
+        if (uPaletteRows > 0 && fPaletteBlend.x >= 0.0) {
+            texel.rgb = texture(uPalette, vec2(texel.r, (fPaletteBlend.x + 0.5) / float(uPaletteRows))).rgb;
+        }
+
+        FragColor = fColor * texel;
 
     } else {
         FragColor = fColor;
     }
+
+    FragColor.rgb = mix(FragColor.rgb, fFlash.rgb, fFlash.a);
+    if (uLighting != 0) { FragColor.rgb *= texture(uLightMap, gl_FragCoord.xy / uSceneSize).rgb; }
+
+    // anything outside of the map is left uncovered
+    if (uFog != 0) {
+        vec2 uv = (fWorldPos - uFogOrigin) / uFogSize;
+        float revealed = (any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0)))) ? 1.0 : texture(uDiscovery, uv).r;
+        FragColor.rgb = mix(uFogColor, FragColor.rgb, revealed);
+    }
+
+    // fully transparent pixels (e.g. the empty parts of a decal layer) should not hide anything behind them in the depth buffer
+    if (FragColor.a <= 0.0) { discard; }
+
+    // premultiplied alpha -- an additive sprite keeps its color but does not cover anything
+    FragColor.rgb *= FragColor.a;
+    if (fPaletteBlend.y > 0.5) { FragColor.a = 0.0; }
 }
 
 /* Personal guide to shader techniques:
@@ -6,8 +6,12 @@ layout (location = 1) in vec4 aColor;
 layout (location = 2) in vec2 aTexCoords;
 layout (location = 3) in float aTexId;
 
-uniform mat4 uProjection;
-uniform mat4 uView;
+layout (std140) uniform Camera {
+    mat4 uProjection;
+    mat4 uView;
+    mat4 uInvProjection;
+    mat4 uInvView;
+};
 
 out vec4 fColor;
 out vec2 fTextCoords;
@@ -0,0 +1,46 @@
+#type vertex
+#version 330 core
+
+layout (location = 0) in vec2 aPos;
+
+layout (std140) uniform Camera {
+    mat4 uProjection;
+    mat4 uView;
+    mat4 uInvProjection;
+    mat4 uInvView;
+};
+
+out vec2 fWorldPos;
+
+void main() {
+    // the projection is orthographic so unprojecting the corners is enough, the rasterizer interpolates the rest linearly
+    fWorldPos = (uInvView * uInvProjection * vec4(aPos, 0.0, 1.0)).xy;
+    gl_Position = vec4(aPos, 0.999, 1.0);
+}
+
+#type fragment
+#version 330 core
+
+uniform vec2 uGridSize;
+uniform vec3 uColor;
+
+in vec2 fWorldPos;
+
+out vec4 FragColor;
+
+void main() {
+    // position in grid cells and how many cells a single pixel covers (zoom is already folded into the inverse matrices)
+    vec2 cell = fWorldPos / uGridSize;
+    vec2 pixel = fwidth(cell);
+
+    // distance to the closest line in pixels
+    vec2 dist = abs(fract(cell - 0.5) - 0.5) / pixel;
+    float line = 1.0 - min(min(dist.x, dist.y), 1.0);
+
+    // fade the grid out once the cells are too small to be readable instead of turning the viewport solid
+    float cellPixels = 1.0 / max(pixel.x, pixel.y);
+    float fade = clamp((cellPixels - 4.0) * 0.25, 0.0, 1.0);
+
+    if (line * fade <= 0.0) { discard; }
+    FragColor = vec4(uColor, line * fade);
+}
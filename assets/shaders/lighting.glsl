@@ -0,0 +1,53 @@
+#type vertex
+#version 330 core
+
+layout (location = 0) in vec2 aPos;
+
+layout (std140) uniform Camera {
+    mat4 uProjection;
+    mat4 uView;
+    mat4 uInvProjection;
+    mat4 uInvView;
+};
+
+out vec2 fWorldPos;
+
+void main() {
+    // the projection is orthographic so unprojecting the corners is enough, the rasterizer interpolates the rest linearly
+    fWorldPos = (uInvView * uInvProjection * vec4(aPos, 0.0, 1.0)).xy;
+    gl_Position = vec4(aPos, 0.0, 1.0);
+}
+
+#type fragment
+#version 330 core
+
+uniform isamplerBuffer uTiles; // offset and count into uIndices for each tile
+uniform isamplerBuffer uIndices;
+uniform samplerBuffer uLights; // 2 texels per light -- (x, y, radius, intensity), (r, g, b, unused)
+uniform int uTilesX;
+uniform int uTileSize;
+uniform vec3 uAmbient;
+
+in vec2 fWorldPos;
+
+out vec4 FragColor;
+
+void main() {
+    ivec2 tile = ivec2(gl_FragCoord.xy) / uTileSize;
+    ivec2 range = texelFetch(uTiles, tile.y * uTilesX + tile.x).xy;
+
+    vec3 light = uAmbient;
+
+    // only the lights that touch this tile
+    for (int i = 0; i < range.y; ++i) {
+        int index = texelFetch(uIndices, range.x + i).r;
+        vec4 shape = texelFetch(uLights, 2*index);
+        vec3 color = texelFetch(uLights, 2*index + 1).rgb;
+
+        // smooth quadratic falloff that reaches 0 at the radius
+        float falloff = clamp(1.0 - length(fWorldPos - shape.xy) / shape.z, 0.0, 1.0);
+        light += color * shape.w * falloff * falloff;
+    }
+
+    FragColor = vec4(light, 1.0);
+}
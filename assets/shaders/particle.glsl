@@ -0,0 +1,47 @@
+#type vertex
+#version 330 core
+
+layout (location = 0) in vec2 aCorner; // corner of the unit quad
+layout (location = 1) in float aPosX; // * the rest are per particle
+layout (location = 2) in float aPosY;
+layout (location = 3) in float aLife;
+layout (location = 4) in float aLifetime;
+layout (location = 5) in float aEmitter; // entry in the parameter table
+
+layout (std140) uniform Camera {
+    mat4 uProjection;
+    mat4 uView;
+    mat4 uInvProjection;
+    mat4 uInvView;
+};
+uniform samplerBuffer uParams; // 3 texels per emitter -- start color, end color, (start size, end size, unused, unused)
+
+out vec4 fColor;
+out vec2 fTexCoords;
+
+void main() {
+    int emitter = 3 * int(aEmitter);
+    vec4 sizes = texelFetch(uParams, emitter + 2);
+
+    float t = 1.0 - clamp(aLife / aLifetime, 0.0, 1.0); // 0 when spawned and 1 when it dies
+    float size = mix(sizes.x, sizes.y, t);
+
+    fColor = mix(texelFetch(uParams, emitter), texelFetch(uParams, emitter + 1), t);
+    fTexCoords = aCorner + 0.5;
+    gl_Position = uProjection * uView * vec4(vec2(aPosX, aPosY) + aCorner * size, 0.0, 1.0);
+}
+
+#type fragment
+#version 330 core
+
+uniform sampler2D uTexture;
+uniform int uTextured;
+
+in vec4 fColor;
+in vec2 fTexCoords;
+
+out vec4 FragColor;
+
+void main() {
+    FragColor = uTextured != 0 ? fColor * texture(uTexture, fTexCoords) : fColor;
+}
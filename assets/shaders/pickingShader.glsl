@@ -6,21 +6,57 @@ layout (location = 1) in vec4 aColor;
 layout (location = 2) in vec2 aTexCoords;
 layout (location = 3) in float aTexId;
 layout (location = 4) in float aEntityId;
+layout (location = 5) in vec3 aAnim; // clip ID, start time, playback rate
 
-uniform mat4 uProjection;
-uniform mat4 uView;
+layout (std140) uniform Camera {
+    mat4 uProjection;
+    mat4 uView;
+    mat4 uInvProjection;
+    mat4 uInvView;
+};
+uniform float uTime;
+uniform samplerBuffer uClips;
+uniform samplerBuffer uFrames;
+uniform vec2 uScrollLag; // 1 - the layer's scroll factor (0 = moves with the world)
+uniform vec2 uRepeat; // distance the layer repeats after (0 = does not repeat)
+uniform vec2 uRepeatCopy; // which copy of a repeating layer is being drawn
 
 out vec4 fColor;
 out vec2 fTextCoords;
 out float fTexId;
 out float fEntityId;
 
+// Pick the current frame's texture coordinates out of the clip table.
+vec2 animTexCoords() {
+    vec4 clip = texelFetch(uClips, int(aAnim.x)); // first frame, frame count, fps, loop
+    int frame = int(floor(max(uTime - aAnim.y, 0.0) * aAnim.z * clip.z));
+    frame = clip.w > 0.5 ? frame % int(clip.y) : min(frame, int(clip.y) - 1);
+
+    vec4 rect = texelFetch(uFrames, int(clip.x) + frame); // left, bottom, right, top
+
+    // the corners of each quad are ordered top right, bottom right, bottom left, top left
+    int corner = gl_VertexID & 3;
+    return vec2(corner < 2 ? rect.z : rect.x, (corner == 0 || corner == 3) ? rect.w : rect.y);
+}
+
+// Where the sprite's layer is moved to by its parallax (see Parallax in render.h).
+// The camera sits at the translation of the inverse view.
+vec2 layerOffset() {
+    vec2 camera = uInvView[3].xy;
+    vec2 offset = camera * uScrollLag;
+
+    // move a repeating layer by whole periods so its first copy starts at or before the camera (the second copy covers the rest)
+    if (uRepeat.x > 0.0) { offset.x += (floor((camera.x - offset.x) / uRepeat.x) + uRepeatCopy.x) * uRepeat.x; }
+    if (uRepeat.y > 0.0) { offset.y += (floor((camera.y - offset.y) / uRepeat.y) + uRepeatCopy.y) * uRepeat.y; }
+    return offset;
+}
+
 void main() {
     fColor = aColor;
-    fTextCoords = aTexCoords;
+    fTextCoords = aAnim.x < 0.0 ? aTexCoords : animTexCoords();
     fTexId = aTexId;
     fEntityId = aEntityId;
-    gl_Position = uProjection * uView * vec4(aPos, 0.0, 1.0);
+    gl_Position = uProjection * uView * vec4(aPos + layerOffset(), 0.0, 1.0);
 }
 
 #type fragment
@@ -38,7 +74,16 @@ out vec3 FragColor;
 void main() {
     vec4 texColor = vec4(1, 1, 1, 1);
 
-    if (fTexId >= 0) {
+    if (fTexId >= 32) {
+        // premultiplied texture -- only its alpha matters here
+        texColor = fColor * texture(uTextures[int(fTexId) - 32], fTextCoords);
+
+    } else if (fTexId >= 16) {
+        // signed distance field (text) -- anything inside the glyph's edge is solid
+        float dist = texture(uTextures[int(fTexId) - 16], fTextCoords).a;
+        texColor = vec4(fColor.rgb, dist >= 0.5 ? fColor.a : 0.0);
+
+    } else if (fTexId >= 0) {
         int id  = int (fTexId);
         texColor = fColor * texture(uTextures[id], fTextCoords);
     }
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cstring>
+#include "component.h"
+
+namespace Dralgeer {
+    // Sprite animations evaluated on the GPU.
+    // Every clip's frames live in a pair of texture buffers that are only uploaded when a clip is added. Each sprite just stores which
+    // clip it is playing, when it started, and how fast, so an animation only costs a rebuffer when it is started or stopped.
+    namespace Animation {
+        struct AnimationClip {
+            int firstFrame; // index of the clip's first frame in the frame table
+            int numFrames;
+            float fps;
+            bool loop;
+            Texture* texture; // texture the frames are from
+        };
+
+        // * Clip table (1 texel per clip -- first frame, frame count, fps, loop).
+        extern AnimationClip* clips;
+        extern int numClips;
+        extern int clipCapacity;
+
+        // * Frame table (1 texel per frame -- left, bottom, right, top).
+        extern float* frames;
+        extern int numFrames;
+        extern int frameCapacity;
+
+        extern unsigned int clipBuffer, clipTex;
+        extern unsigned int frameBuffer, frameTex;
+        extern bool started, rebuffer; // rebuffer = a clip was added since the tables were last uploaded
+
+        extern float time; // time used by every animation for the frame being drawn (set by whoever draws it)
+
+        inline void start() {
+            // the shaders always sample from the tables so they must exist even if no clips have been added
+            glGenBuffers(1, &clipBuffer);
+            GLState::bindBuffer(GL_TEXTURE_BUFFER, clipBuffer);
+            glBufferData(GL_TEXTURE_BUFFER, clipCapacity * 4 * sizeof(float), NULL, GL_STATIC_DRAW);
+
+            glGenTextures(1, &clipTex);
+            GLState::bindTexture(GL_TEXTURE_BUFFER, clipTex);
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, clipBuffer);
+
+            glGenBuffers(1, &frameBuffer);
+            GLState::bindBuffer(GL_TEXTURE_BUFFER, frameBuffer);
+            glBufferData(GL_TEXTURE_BUFFER, frameCapacity * 4 * sizeof(float), NULL, GL_STATIC_DRAW);
+
+            glGenTextures(1, &frameTex);
+            GLState::bindTexture(GL_TEXTURE_BUFFER, frameTex);
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, frameBuffer);
+
+            rebuffer = numClips > 0;
+            started = 1;
+        };
+
+        // Upload any clips that were added.
+        // Call once per frame while nothing is drawing with the tables.
+        inline void update() {
+            if (!rebuffer || !started) { return; }
+
+            // the tables are tiny so just reupload the whole thing
+            float* clipData = new float[numClips * 4];
+            for (int i = 0; i < numClips; ++i) {
+                clipData[4*i] = clips[i].firstFrame;
+                clipData[4*i + 1] = clips[i].numFrames;
+                clipData[4*i + 2] = clips[i].fps;
+                clipData[4*i + 3] = clips[i].loop;
+            }
+
+            GLState::bindBuffer(GL_TEXTURE_BUFFER, clipBuffer);
+            glBufferData(GL_TEXTURE_BUFFER, clipCapacity * 4 * sizeof(float), NULL, GL_STATIC_DRAW);
+            glBufferSubData(GL_TEXTURE_BUFFER, 0, numClips * 4 * sizeof(float), clipData);
+
+            GLState::bindBuffer(GL_TEXTURE_BUFFER, frameBuffer);
+            glBufferData(GL_TEXTURE_BUFFER, frameCapacity * 4 * sizeof(float), NULL, GL_STATIC_DRAW);
+            glBufferSubData(GL_TEXTURE_BUFFER, 0, numFrames * 4 * sizeof(float), frames);
+
+            RenderStats::uploaded((numClips + numFrames) * 4 * sizeof(float));
+            delete[] clipData;
+            rebuffer = 0;
+        };
+
+        // Bind the tables for a shader that is already in use.
+        inline void bind(Shader const &shader) {
+            GLState::bindTexture(ANIM_CLIP_TEX_SLOT, GL_TEXTURE_BUFFER, clipTex);
+            GLState::bindTexture(ANIM_FRAME_TEX_SLOT, GL_TEXTURE_BUFFER, frameTex);
+
+            shader.uploadInt("uClips", ANIM_CLIP_TEX_SLOT);
+            shader.uploadInt("uFrames", ANIM_FRAME_TEX_SLOT);
+            shader.uploadFloat("uTime", time);
+        };
+
+        inline void destroy() {
+            delete[] clips;
+            delete[] frames;
+
+            clips = nullptr;
+            frames = nullptr;
+            numClips = 0;
+            numFrames = 0;
+
+            if (started) {
+                glDeleteTextures(1, &clipTex);
+                glDeleteTextures(1, &frameTex);
+                glDeleteBuffers(1, &clipBuffer);
+                glDeleteBuffers(1, &frameBuffer);
+
+                GLState::forgetTexture(clipTex);
+                GLState::forgetTexture(frameTex);
+                GLState::forgetBuffer(clipBuffer);
+                GLState::forgetBuffer(frameBuffer);
+                started = 0;
+            }
+        };
+
+        // Add a clip made of count sprites from the SpriteSheet starting at first.
+        // Returns the clip's ID.
+        inline int addClip(SpriteSheet const &sheet, int first, int count, float fps, bool loop = 1) {
+            if (first < 0 || count <= 0 || first + count > sheet.numSprites) {
+                throw std::runtime_error("[ERROR] Animation clip is out of the range of the SpriteSheet.");
+            }
+
+            if (numClips == clipCapacity) {
+                clipCapacity *= 2;
+                AnimationClip* temp = new AnimationClip[clipCapacity];
+                for (int i = 0; i < numClips; ++i) { temp[i] = clips[i]; }
+
+                delete[] clips;
+                clips = temp;
+            }
+
+            if (numFrames + count > frameCapacity) {
+                while (numFrames + count > frameCapacity) { frameCapacity *= 2; }
+                float* temp = new float[frameCapacity * 4];
+                std::memcpy(temp, frames, numFrames * 4 * sizeof(float));
+
+                delete[] frames;
+                frames = temp;
+            }
+
+            // texCoords[2] is the bottom left corner and texCoords[0] is the top right corner
+            for (int i = 0; i < count; ++i) {
+                Sprite const &s = sheet.sprites[first + i];
+                float* frame = &frames[4 * (numFrames + i)];
+
+                frame[0] = s.texCoords[2].x;
+                frame[1] = s.texCoords[2].y;
+                frame[2] = s.texCoords[0].x;
+                frame[3] = s.texCoords[0].y;
+            }
+
+            clips[numClips] = {numFrames, count, fps, loop, sheet.sprites[first].texture};
+            numFrames += count;
+            rebuffer = 1;
+
+            return numClips++;
+        };
+
+        // Start playing a clip on a sprite from its first frame.
+        // The clip must use the same texture as the sprite.
+        inline void play(SpriteRenderer* spr, int clip, float rate = 1.0f) {
+            if (clip < 0 || clip >= numClips) { return; }
+
+            if (clips[clip].texture != spr->sprite.texture) {
+                std::cout << "[INFO] Animation clip uses a different texture than the sprite.\n";
+                return;
+            }
+
+            spr->animClip = clip;
+            spr->animStart = (float) glfwGetTime();
+            spr->animRate = rate < 0.0f ? 0.0f : rate;
+            spr->isDirty = 1;
+        };
+
+        // Stop animating a sprite. It goes back to displaying its sprite's texCoords.
+        inline void stop(SpriteRenderer* spr) {
+            if (spr->animClip < 0) { return; }
+
+            spr->animClip = -1;
+            spr->isDirty = 1;
+        };
+
+        // Is the sprite's clip still changing frames at time now?
+        // A clip that does not loop holds its last frame once it ends so it no longer needs new frames drawn.
+        inline bool isPlaying(SpriteRenderer const* spr, float now) {
+            if (spr->animClip < 0 || spr->animClip >= numClips) { return 0; }
+
+            AnimationClip const &clip = clips[spr->animClip];
+            return clip.loop ? spr->animRate > 0.0f : (now - spr->animStart) * spr->animRate * clip.fps < clip.numFrames;
+        };
+    }
+}
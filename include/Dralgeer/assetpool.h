@@ -4,6 +4,7 @@
 // #define ASSET_POOL_H
 
 #include "component.h"
+#include "text.h"
 
 namespace Dralgeer {
     namespace AssetPool {
@@ -11,6 +12,7 @@ namespace Dralgeer {
             static std::unordered_map<std::string, Shader*> shaders;
             static std::unordered_map<std::string, Texture*> textures;
             static std::unordered_map<std::string, SpriteSheet*> spriteSheets;
+            static std::unordered_map<std::string, Font*> fonts;
         }
 
         inline static Shader* getShader(std::string const &filepath) {
@@ -50,10 +52,21 @@ namespace Dralgeer {
             // return nullptr;
         };
 
+        inline static Font* getFont(std::string const &filepath) {
+            if (fonts.find(filepath) != fonts.end()) { return fonts[filepath]; }
+
+            // add new font if it is not included
+            Font* font = new Font();
+            font->init(filepath);
+            fonts.insert({filepath, font});
+            return font;
+        };
+
         inline static void destroy() {
             for (auto const &i : shaders) { if (i.second) { delete i.second; }}
             for (auto const &i : textures) { if (i.second) { delete i.second; }}
             for (auto const &i : spriteSheets) { if (i.second) { delete i.second; }}
+            for (auto const &i : fonts) { if (i.second) { delete i.second; }}
         };
     }
 }
@@ -40,6 +40,15 @@ namespace Dralgeer {
             glm::vec4 color = glm::vec4(1, 1, 1, 1); // for some reason it doesn't work unless I have the equals
             Sprite sprite;
 
+            // Animation state. The current frame is picked in the vertex shader from these so a playing animation never dirties the sprite.
+            // Use Animation::play and Animation::stop to change these.
+            int animClip = -1; // -1 = not animated
+            float animStart = 0.0f; // time the clip started playing at
+            float animRate = 1.0f; // playback speed multiplier
+
+            // Entry in the material table (see Materials). Changing the material itself never dirties the sprite.
+            int material = 0; // 0 = default material
+
             Transform transform, lastTransform;
             bool isDirty = 1;
             bool rebufferZIndex = 0;
@@ -132,12 +141,45 @@ namespace Dralgeer {
             void update(float dt, bool wantCapture);
     };
 
+    // Editor grid drawn as a single viewport sized quad. The lines themselves are computed in the grid shader from world coordinates
+    // so there is no per-frame CPU work or vertex upload.
     class GridLines {
+        private:
+            Shader* shader = nullptr; // owned by whoever passed it in (or the AssetPool)
+            unsigned int vaoID, vboID;
+            bool started = 0;
+
         public:
             int id;
 
             inline GridLines() { id = IDCounter::componentID++; };
-            void update(Camera const &cam);
+
+            // Draw with a shader that is already compiled (grid.glsl) instead of getting it from the AssetPool.
+            inline GridLines(Shader* shader) : shader(shader) { id = IDCounter::componentID++; };
+
+
+            // * ===================
+            // * Rule of 5 Stuff
+            // * ===================
+
+            // ? Copies do not share the GPU quad. They will lazily create their own the first time they are rendered.
+
+            inline GridLines(GridLines const &gl) : shader(gl.shader) { id = IDCounter::componentID++; };
+            GridLines(GridLines &&gl);
+            GridLines& operator = (GridLines const &gl);
+            GridLines& operator = (GridLines &&gl);
+            ~GridLines();
+
+
+            // * ===================
+            // * Normal Functions
+            // * ===================
+
+            void start();
+
+            // Draw the grid behind everything rendered afterwards. Depth writes are disabled for the draw.
+            // The camera is read from the camera UBO so GLState::setCamera must be called first.
+            void render();
     };
 
     class MouseControls {
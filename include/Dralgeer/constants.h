@@ -25,28 +25,131 @@
 #define IMGUI_COLOR_PCIKER_HEIGHT 450
 
 // debug draw
-#define MAX_DEBUG_LINES 500
-#define DEBUG_VERTEX_ARR_SIZE 6000
+#define DEBUG_START_CAPACITY 64
+#define DEBUG_CIRCLE_SEGMENTS 24
 #define DEBUG_VERTEX_SIZE 5
+#define DEBUG_LINE_SIZE (2 * DEBUG_VERTEX_SIZE)
 #define DEBUG_VERTEX_SIZE_BYTES (DEBUG_VERTEX_SIZE * sizeof(float))
+#define DEBUG_LINE_SIZE_BYTES (DEBUG_LINE_SIZE * sizeof(float))
 #define DEBUG_COLOR_OFFSET (2 * sizeof(float))
 
+// physics debug overlay
+#define PHYSICS_DEBUG_MARKER_SIZE 3.0f
+#define PHYSICS_DEBUG_NORMAL_LENGTH 16.0f
+
+// GL state
+#define GL_STATE_TEXTURE_UNITS 32
+#define GPU_ALLOW_DSA 1 // set to 0 to always use the GL 3.3 bind-to-edit path
+#define CAMERA_UBO_BINDING 0
+#define CAMERA_UBO_SIZE_BYTES (4 * 16 * sizeof(float)) // projection, view, and their inverses
+
 // renderer
 #define MAX_RENDER_BATCHES 1000
-#define MAX_RENDER_BATCH_SIZE 1000
-#define MAX_RENDER_VERTICES_LIST_SIZE 40000
-#define MAX_RENDER_INDICES_LIST_SIZE 6000
+#define MAX_RENDER_BATCH_SIZE 1000 // sprites per editor batch (a batch's vertex and index buffers are sized from its capacity)
 #define MAX_TEXTURES 16
+#define SDF_TEX_ID_OFFSET MAX_TEXTURES // added to the texture ID of sprites using a signed distance field texture
+#define PREMULTIPLIED_TEX_ID_OFFSET (2*MAX_TEXTURES) // added to the texture ID of sprites using a premultiplied alpha texture
+#define SPRITE_FRAGMENT_SAMPLERS (MAX_TEXTURES + 3) // default.glsl also samples the light map, palette, and discovery texture per pixel
 
 #define COLOR_OFFSET (2 * sizeof(float))
 #define TEX_COORDS_OFFSET (6 * sizeof(float))
 #define TEX_ID_OFFSET (8 * sizeof(float))
 #define ENTITY_ID_OFFSET (9 * sizeof(float))
+#define ANIM_OFFSET (10 * sizeof(float))
+#define MATERIAL_OFFSET (13 * sizeof(float))
 
-#define VERTEX_SIZE 10
-#define SPRITE_SIZE 40
+#define VERTEX_SIZE 14
+#define SPRITE_SIZE (4 * VERTEX_SIZE)
 #define VERTEX_SIZE_BYTES (VERTEX_SIZE * sizeof(float))
 #define SPRITE_SIZE_BYTES (SPRITE_SIZE * sizeof(float))
+#define STATIC_BATCH_UPLOAD_BUDGET (256 * 1024) // bytes of a static batch uploaded per frame once it is built
+
+// sprite animation
+#define ANIM_START_CAPACITY 16
+#define ANIM_CLIP_TEX_SLOT 16 // the clip table sits just after the sprite texture slots
+#define ANIM_FRAME_TEX_SLOT 17
+
+// lighting
+#define LIGHT_START_CAPACITY 16
+#define LIGHT_MAP_SCALE 0.25f // resolution of the light map relative to the scene
+#define LIGHT_TILE_SIZE 16 // in light map pixels
+#define LIGHT_TILES_TEX_SLOT 18
+#define LIGHT_INDICES_TEX_SLOT 19
+#define LIGHT_DATA_TEX_SLOT 20
+#define LIGHT_MAP_TEX_SLOT 21
+
+// materials
+#define MATERIAL_START_CAPACITY 16
+#define MATERIAL_SIZE 12 // floats per material (3 texels)
+#define MATERIAL_SIZE_BYTES (MATERIAL_SIZE * sizeof(float))
+#define MATERIAL_TABLE_TEX_SLOT 22
+#define MATERIAL_PALETTE_TEX_SLOT 23
+
+// text
+#define FONT_FIRST_CHAR 32 // ' '
+#define FONT_NUM_GLYPHS 95 // every printable ASCII character
+#define FONT_PIXEL_HEIGHT 32.0f // size the glyphs are rasterized at (a distance field scales well past this)
+#define FONT_SDF_PADDING 6 // pixels of distance field around each glyph
+#define FONT_ATLAS_SIZE 512
+
+// render thread
+#define RENDER_SNAPSHOT_START_CAPACITY 64
+#define RENDER_TIMER_QUERIES 3 // a query is read this many frames after it is issued so reading it never stalls
+
+// frame capture
+#define FRAME_CAPTURE_RING 3 // readbacks in flight at once (a capture is skipped while they are all busy)
+#define FRAME_CAPTURE_MAX_QUEUED 8 // frames waiting to be encoded (a capture is dropped if the encoder falls this far behind)
+
+// render stats
+#define RENDER_STATS_HISTORY 240 // frames kept for the stats panel's graphs
+#define RENDER_STATS_MAX_LAYERS 64 // layers listed per frame (the rest are still counted in the totals)
+
+// dynamic resolution
+#define RENDER_SCALE_MIN 0.5f
+#define RENDER_SCALE_MAX 1.0f
+#define RENDER_SCALE_MAX_STEP 0.1f // most the scale can change by in one adjustment
+#define RENDER_SCALE_COOLDOWN 15 // frames to wait after an adjustment before making another
+#define RENDER_TARGET_GPU_TIME (1000.0f/60.0f) // ms
+#define RENDER_LOAD_LOW 0.65f // raise the scale below this fraction of the target time
+#define RENDER_LOAD_HIGH 0.9f // lower the scale above this fraction of the target time
+#define RENDER_LOAD_AIM 0.8f // fraction of the target time an adjustment aims for
+#define RENDER_TIME_SMOOTHING 0.1f
+
+// idle editor loop
+#define IDLE_GRACE_FRAMES 5 // frames to keep drawing after the last change (lets ImGui finish reacting to input)
+#define IDLE_WAIT_TIMEOUT 0.5 // most seconds to block for while idle
+
+// frame pacing
+#define FRAME_PACING_HISTORY 240 // frames of timings kept
+#define FRAME_PACING_DEFAULT_FPS 60.0f
+#define FRAME_PACING_SPIN_TIME 0.002 // seconds before the deadline the limiter stops sleeping and spins
+
+// particles
+#define PARTICLE_START_EMITTERS 8
+#define PARTICLE_PARAMS_SIZE 12 // floats per emitter in the parameter table (3 texels)
+#define PARTICLE_PARAMS_TEX_SLOT 25
+
+// decals
+#define DECAL_MAX_LAYERS 4 // per room
+#define DECAL_START_CAPACITY 32 // pending decals
+#define DECAL_VERTEX_SIZE 8 // position, texture coords, color
+#define DECAL_PIXELS_PER_UNIT 1.0f // resolution of a layer's texture in world units
+#define DECAL_MAX_TEXTURE_SIZE 4096
+#define DECAL_EDITOR_LAYER_SIZE 2048.0f // world units covered by the level editor's layer (starting at the origin)
+#define DECAL_EDITOR_Z_INDEX 1 // just over the floor
+
+// fog of war
+#define DISCOVERY_TEX_SLOT 24
+#define NUM_TEX_SLOTS (PARTICLE_PARAMS_TEX_SLOT + 1) // texture units the renderer binds to (the particle table has the last one)
+#define DISCOVERY_CELL_SIZE 16.0f // world units per cell
+#define DISCOVERY_EDITOR_CELLS 128 // cells along each side of the level editor's map (starting at the origin)
+#define DISCOVERY_VIEW_RADIUS 256.0f // world units revealed around the center of the view while the scene is playing
+
+// frame graph
+#define FRAME_GRAPH_MAX_PASSES 16
+#define FRAME_GRAPH_MAX_RESOURCES 16
+#define FRAME_GRAPH_MAX_PASS_IO 4 // reads or writes a single pass can declare
+#define FRAME_GRAPH_TRANSIENT_LIFETIME 60 // frames a pooled target can go unused before it is freed
 
 // static batch
 // #define MAX_STATIC_BATCH_SIZE 1500
@@ -55,8 +158,6 @@
 
 // dynamic batch
 #define MAX_DYNAMIC_BATCH_SIZE 100
-#define MAX_DYNAMIC_VERTICES_SIZE 4000
-#define MAX_DYNAMIC_INDICES_SIZE 600
 
 // // gizmo batch specifics
 // #define GIZMO_BATCH_SIZE 4
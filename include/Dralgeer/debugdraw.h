@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstring>
+#include <cmath>
 #include "assetpool.h"
 #include "camera.h"
 
@@ -12,139 +14,227 @@ namespace Dralgeer {
             int lifetime;
         };
 
-
+        // * Persistent lines (lifetime > 1 or negative).
+        // * These are unordered so an expired line can be swapped out with the last one in O(1).
         extern Line2D* lines;
+        extern float* pVertices; // vertices of the persistent lines (parallel to lines)
         extern int numLines;
         extern int capacity;
 
-        // 6 floats per vertex, 2 vertices per line
-        extern float vertices[DEBUG_VERTEX_ARR_SIZE];
-        extern Shader shader;
+        // * Transient lines (lifetime of 1).
+        // * These only live until they have been drawn once so the whole store is reset in O(1) after every draw.
+        extern float* tVertices;
+        extern int numTransient;
+        extern int tCapacity;
 
-        extern unsigned int vaoID, vboID;
-        extern bool started, rebuffer;
+        extern Shader* shader;
 
-        inline void loadVertexProperties(int index) {
-            int offset = index * 2 * DEBUG_VERTEX_SIZE;
+        extern unsigned int vaoID, vboID;
+        extern int gpuCapacity; // number of lines the VBO can hold before it has to be reallocated
+        extern bool started, rebuffer; // rebuffer = the persistent lines changed since they were last uploaded
 
+        // 5 floats per vertex, 2 vertices per line
+        inline void loadVertexProperties(float* vertices, glm::vec2 const &start, glm::vec2 const &end, glm::vec3 const &color) {
             // * Starting vertex
             // load position
-            vertices[offset] = lines[index].start.x;
-            vertices[offset + 1] = lines[index].start.y;
+            vertices[0] = start.x;
+            vertices[1] = start.y;
 
             // load color
-            vertices[offset + 2] = lines[index].color.x;
-            vertices[offset + 3] = lines[index].color.y;
-            vertices[offset + 4] = lines[index].color.z;
+            vertices[2] = color.x;
+            vertices[3] = color.y;
+            vertices[4] = color.z;
 
             // * Ending vertex
             // load position
-            vertices[offset + 5] = lines[index].end.x;
-            vertices[offset + 6] = lines[index].end.y;
+            vertices[5] = end.x;
+            vertices[6] = end.y;
 
             // load color
-            vertices[offset + 7] = lines[index].color.x;
-            vertices[offset + 8] = lines[index].color.y;
-            vertices[offset + 9] = lines[index].color.z;
+            vertices[7] = color.x;
+            vertices[8] = color.y;
+            vertices[9] = color.z;
         };
 
-        inline void start() {
-            // initialize the shader
-            shader = *(AssetPool::getShader("../../assets/shaders/debugLine2D.glsl"));
-
-            // generate the VAO
-            glGenVertexArrays(1, &vaoID);
-            glBindVertexArray(vaoID);
+        // lineShader = debugLine2D.glsl (must outlive stop())
+        inline void start(Shader* lineShader) {
+            shader = lineShader;
 
-            // create the VBO and buffer some memory
-            glGenBuffers(1, &vboID);
-            glBindBuffer(GL_ARRAY_BUFFER, vboID);
-            glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_DYNAMIC_DRAW);
+            // create the VBO and reserve some memory (it is only ever filled up to the number of lines in use)
+            vboID = GPU::createBuffer(GL_ARRAY_BUFFER, gpuCapacity * DEBUG_LINE_SIZE_BYTES, NULL, GL_DYNAMIC_DRAW);
 
-            // enable the vertex array attributes
-            glVertexAttribPointer(0, 2, GL_FLOAT, 0, DEBUG_VERTEX_SIZE_BYTES, (void*) 0);
-            glVertexAttribPointer(1, 3, GL_FLOAT, 0, DEBUG_VERTEX_SIZE_BYTES, (void*) DEBUG_COLOR_OFFSET);
-            glEnableVertexAttribArray(0);
-            glEnableVertexAttribArray(1);
+            // generate the VAO (position and color)
+            static GPU::VertexAttribute const attributes[2] = {{2, 0}, {3, DEBUG_COLOR_OFFSET}};
+            vaoID = GPU::createVertexArray(vboID, 0, DEBUG_VERTEX_SIZE_BYTES, attributes, 2);
 
             glLineWidth(2.0f);
             started = 1;
         };
 
         inline void beginFrame() {
-            if (!started) { start(); }
-
             // remove dead lines
-            for (int i = numLines - 1; i >= 0; i--) {
-                if (lines[i].lifetime < 0) { std::cout << "Love is beautiful\n"; continue; } // if the user entered a negative value, make the line last forever
-
-                if (--lines[i].lifetime < 0) { // todo i have no idea why this isn't working
-                    numLines--;
-                    for (int j = i; j < numLines; ++j) {
-                        lines[j] = lines[j + 1];
-                        rebuffer = 1;
-                    }
+            for (int i = numLines - 1; i >= 0; --i) {
+                if (lines[i].lifetime < 0) { continue; } // if the user entered a negative value, make the line last forever
+
+                if (--lines[i].lifetime < 0) {
+                    // order does not matter so move the last line into the empty slot
+                    --numLines;
+                    lines[i] = lines[numLines];
+                    std::memcpy(&pVertices[i * DEBUG_LINE_SIZE], &pVertices[numLines * DEBUG_LINE_SIZE], DEBUG_LINE_SIZE_BYTES);
+                    rebuffer = 1;
                 }
             }
         };
 
-        inline void draw(Camera const &cam) {
-            if (!numLines) { return; }
+        // Draw lines from arrays laid out like the stores above.
+        // Must be called from the context that called start().
+        // The camera is read from the camera UBO so GLState::setCamera must be called first.
+        // reupload = the persistent lines changed since they were last drawn
+        inline void drawLines(float const* persistent, int numPersistent, bool reupload, float const* transient, int numTransient) {
+            int total = numPersistent + numTransient;
+            if (!total) { return; }
+
+            // grow the VBO if needed (this orphans the old storage so the persistent lines must be reuploaded)
+            if (total > gpuCapacity) {
+                while (gpuCapacity < total) { gpuCapacity *= 2; }
+                GPU::bufferData(GL_ARRAY_BUFFER, vboID, gpuCapacity * DEBUG_LINE_SIZE_BYTES, NULL, GL_DYNAMIC_DRAW);
+                reupload = 1;
+            }
 
-            if (rebuffer) {
-                glBindBuffer(GL_ARRAY_BUFFER, vboID);
-                glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-                glBindBuffer(GL_ARRAY_BUFFER, 0);
-                rebuffer = 0;
+            // only upload the range in use
+            // the persistent lines sit at the start of the buffer and the transient lines directly after them
+            if (reupload && numPersistent) { GPU::bufferSubData(GL_ARRAY_BUFFER, vboID, 0, numPersistent * DEBUG_LINE_SIZE_BYTES, persistent); }
+            if (numTransient) {
+                GPU::bufferSubData(GL_ARRAY_BUFFER, vboID, numPersistent * DEBUG_LINE_SIZE_BYTES, numTransient * DEBUG_LINE_SIZE_BYTES, transient);
             }
 
-            // bind the VAO
-            glBindVertexArray(vaoID);
-            glEnableVertexAttribArray(0);
-            glEnableVertexAttribArray(1);
+            GLState::bindVertexArray(vaoID);
+            shader->use();
 
-            // use our shader
-            shader.use();
-            shader.uploadMat4("uProjection", cam.proj);
-            shader.uploadMat4("uView", cam.view);
+            // draw every line with a single call
+            glDrawArrays(GL_LINES, 0, 2*total);
+            RenderStats::countDraw();
+        };
 
-            // draw the batch
-            glDrawArrays(GL_LINES, 0, 2*numLines);
+        inline void draw() {
+            drawLines(pVertices, numLines, rebuffer, tVertices, numTransient);
 
-            // disable the location
-            glDisableVertexAttribArray(0);
-            glDisableVertexAttribArray(1);
-            glBindVertexArray(0);
+            // the transient lines have been drawn so throw them all out
+            rebuffer = 0;
+            numTransient = 0;
+        };
+
+        // Free the GPU objects.
+        // Must be called from the context that called start().
+        inline void stop() {
+            if (!started) { return; }
 
-            // unbind shader
-            shader.detach();
+            glDeleteVertexArrays(1, &vaoID);
+            GPU::deleteBuffers(1, &vboID);
+            GLState::forgetVertexArray(vaoID);
+            started = 0;
         };
 
-        inline void destroy() { delete lines; };
+        inline void destroy() {
+            delete[] lines;
+            delete[] pVertices;
+            delete[] tVertices;
+
+            lines = nullptr;
+            pVertices = nullptr;
+            tVertices = nullptr;
+            numLines = 0;
+            numTransient = 0;
+            capacity = 0;
+            tCapacity = 0;
+
+            stop();
+        };
 
         // * Note: Make the lifetime negative to indicate it should never be removed
         inline void addLine2D(glm::vec2 const &start, glm::vec2 const &end, glm::vec3 const &color = glm::vec3(0.8824f, 0.0039f, 0.0039f), int lifetime = 1) {
-            if (numLines >= MAX_DEBUG_LINES) { return; }
+            if (lifetime == 1) {
+                if (numTransient == tCapacity) {
+                    tCapacity = tCapacity ? 2*tCapacity : DEBUG_START_CAPACITY; // destroy() leaves it at 0
+                    float* temp = new float[tCapacity * DEBUG_LINE_SIZE];
+                    std::memcpy(temp, tVertices, numTransient * DEBUG_LINE_SIZE_BYTES);
+
+                    delete[] tVertices;
+                    tVertices = temp;
+                }
 
-            // std::cout << numLines << "\n";
+                loadVertexProperties(&tVertices[DEBUG_LINE_SIZE * numTransient++], start, end, color);
+                return;
+            }
 
             if (numLines == capacity) {
-                capacity *= 2;
+                capacity = capacity ? 2*capacity : DEBUG_START_CAPACITY; // destroy() leaves it at 0
                 Line2D* temp = new Line2D[capacity];
+                float* tempVerts = new float[capacity * DEBUG_LINE_SIZE];
 
                 for (int i = 0; i < numLines; ++i) { temp[i] = lines[i]; }
+                std::memcpy(tempVerts, pVertices, numLines * DEBUG_LINE_SIZE_BYTES);
 
-                delete lines;
+                delete[] lines;
+                delete[] pVertices;
                 lines = temp;
+                pVertices = tempVerts;
             }
 
             rebuffer = 1;
-            lines[numLines++] = {start, end, color, lifetime};
-            loadVertexProperties(numLines - 1);
+            lines[numLines] = {start, end, color, lifetime};
+            loadVertexProperties(&pVertices[DEBUG_LINE_SIZE * numLines++], start, end, color);
+        };
+
+        // Add a closed outline through each of the points passed in.
+        inline void addPolygon(glm::vec2 const* points, int size, glm::vec3 const &color = glm::vec3(0.8824f, 0.0039f, 0.0039f), int lifetime = 1) {
+            for (int i = 0, j = size - 1; i < size; j = i++) { addLine2D(points[j], points[i], color, lifetime); }
+        };
+
+        // Add the outline of a (possibly rotated) box.
+        // rotation is in degrees and is applied about the center.
+        inline void addBox2D(glm::vec2 const &center, glm::vec2 const &dimensions, float rotation = 0.0f,
+                glm::vec3 const &color = glm::vec3(0.8824f, 0.0039f, 0.0039f), int lifetime = 1)
+        {
+            glm::vec2 halfsize = dimensions * 0.5f;
+            glm::vec2 vertices[4] = {
+                glm::vec2(-halfsize.x, -halfsize.y), glm::vec2(-halfsize.x, halfsize.y),
+                glm::vec2(halfsize.x, halfsize.y), glm::vec2(halfsize.x, -halfsize.y)
+            };
+
+            float c = 1.0f, s = 0.0f;
+            if (rotation != 0.0f) {
+                float theta = glm::radians(rotation);
+                c = cosf(theta);
+                s = sinf(theta);
+            }
+
+            for (int i = 0; i < 4; ++i) {
+                vertices[i] = center + glm::vec2(vertices[i].x * c - vertices[i].y * s, vertices[i].x * s + vertices[i].y * c);
+            }
+
+            addPolygon(vertices, 4, color, lifetime);
+        };
+
+        // Add the outline of a circle approximated with the given number of segments.
+        inline void addCircle(glm::vec2 const &center, float radius, glm::vec3 const &color = glm::vec3(0.8824f, 0.0039f, 0.0039f),
+                int lifetime = 1, int segments = DEBUG_CIRCLE_SEGMENTS)
+        {
+            // rotate a single offset around the center instead of calling sin and cos for every segment
+            float theta = 6.28318531f/segments;
+            float c = cosf(theta), s = sinf(theta);
+
+            glm::vec2 offset(radius, 0.0f);
+            glm::vec2 last = center + offset;
+
+            for (int i = 0; i < segments; ++i) {
+                offset = glm::vec2(offset.x * c - offset.y * s, offset.x * s + offset.y * c);
+                glm::vec2 curr = center + offset;
+                addLine2D(last, curr, color, lifetime);
+                last = curr;
+            }
         };
 
-        // TODO: add addBox2D funcs
-        // TODO: add addCircle funcs
         // TODO: add constants for common colors
     }
 }
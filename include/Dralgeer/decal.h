@@ -0,0 +1,98 @@
+#pragma once
+
+#include "assetpool.h"
+
+namespace Dralgeer {
+    // A sprite stamped once into a decal layer (blood splats, scorch marks, rubble, etc).
+    struct Decal {
+        Sprite sprite;
+        glm::vec2 pos; // bottom left corner like a Transform
+        glm::vec2 scale;
+        float rotation = 0.0f; // degrees around pos
+        glm::vec4 color = glm::vec4(1, 1, 1, 1);
+    };
+
+    // Accumulation texture covering a room that decals are baked into when they are spawned.
+    // The layer is displayed as a single sprite so a room's decals only ever cost one quad per layer no matter how many were stamped.
+    // Decals are queued and drawn into the texture on the main context right before the frame is captured.
+    class DecalLayer {
+        private:
+            unsigned int fboID = 0; // main context's (FBOs are not shared with the render thread)
+            Decal* pending = nullptr;
+            int numPending = 0;
+            int capacity = 0;
+
+        public:
+            Texture* texture = nullptr;
+            SpriteRenderer* quad = nullptr; // sprite displaying the texture (add it to the render thread like any other sprite)
+            glm::vec2 origin, size; // world region the layer covers
+
+            inline DecalLayer() {};
+
+            // ? Do not allow for reassignment or construction of a DecalLayer from another DecalLayer
+
+            inline DecalLayer(DecalLayer const &dl) { throw std::runtime_error("[ERROR] Cannot constructor a DecalLayer from another DecalLayer."); };
+            inline DecalLayer(DecalLayer &&dl) { throw std::runtime_error("[ERROR] Cannot constructor a DecalLayer from another DecalLayer."); };
+            inline DecalLayer& operator = (DecalLayer const &dl) { throw std::runtime_error("[ERROR] Cannot reassign a DecalLayer object. Do NOT use the '=' operator."); };
+            inline DecalLayer& operator = (DecalLayer &&dl) { throw std::runtime_error("[ERROR] Cannot reassign a DecalLayer object. Do NOT use the '=' operator."); };
+
+            ~DecalLayer();
+
+            // * ====================
+            // * Normal Functions
+            // * ====================
+
+            // Make a cleared layer covering size world units from origin. Must be called with the main context current.
+            void init(glm::vec2 const &origin, glm::vec2 const &size, int zIndex);
+
+            inline bool isInitialized() const { return texture != nullptr; };
+
+            // Queue a decal to be baked into the layer.
+            inline void stamp(Decal const &decal) {
+                if (numPending == capacity) {
+                    capacity = capacity ? 2*capacity : DECAL_START_CAPACITY;
+                    Decal* temp = new Decal[capacity];
+                    for (int i = 0; i < numPending; ++i) { temp[i] = pending[i]; }
+
+                    delete[] pending;
+                    pending = temp;
+                }
+
+                pending[numPending++] = decal;
+            };
+
+            // Bake the queued decals into the texture. Dirties the quad if anything was drawn.
+            // Call while the render thread is not drawing (e.g. after RenderThread::wait()).
+            void flush();
+
+            // Throw out every decal baked into the layer.
+            void clear();
+
+            // Write the layer's texture to a PNG.
+            void save(std::string const &filepath) const;
+
+            // Read a PNG written by save(). Returns false if the file does not exist or is the wrong size.
+            bool load(std::string const &filepath);
+    };
+
+    // GPU objects shared by every decal layer.
+    namespace Decals {
+        extern Shader* shader;
+        extern unsigned int vaoID, vboID;
+        extern int vboCapacity; // decals the VBO has room for
+        extern bool started;
+
+        // Must be called from the main context.
+        void start();
+
+        // Free a layer's texture once the render thread can no longer be drawing with it.
+        // The render thread only lets go of its copy of the layer's sprite in the frame after the layer is freed, so the texture is
+        // kept around for one more frame than that.
+        void release(Texture* texture);
+
+        // Free the textures that are no longer used. Call once per frame after RenderThread::wait().
+        void collect();
+
+        void destroy();
+    }
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+#include "assetpool.h"
+
+namespace Dralgeer {
+    // Cells of a room the player has revealed.
+    // Each room keeps its own bitset. Only the active room's is mirrored into the fog texture and only the rectangle of cells that
+    // changed since it was last mirrored is uploaded.
+    class DiscoveryMap {
+        public:
+            uint64_t* bits = nullptr; // 1 bit per cell, row by row from the bottom left
+            int width = 0, height = 0; // in cells
+            glm::vec2 origin; // world position of the bottom left corner
+            float cellSize;
+
+            int dirtyX0, dirtyY0, dirtyX1, dirtyY1; // cells changed since the fog texture last mirrored them (dirtyX0 > dirtyX1 = none)
+
+            inline DiscoveryMap() {};
+
+            // ? Do not allow for reassignment or construction of a DiscoveryMap from another DiscoveryMap
+
+            inline DiscoveryMap(DiscoveryMap const &dm) { throw std::runtime_error("[ERROR] Cannot constructor a DiscoveryMap from another DiscoveryMap."); };
+            inline DiscoveryMap(DiscoveryMap &&dm) { throw std::runtime_error("[ERROR] Cannot constructor a DiscoveryMap from another DiscoveryMap."); };
+            inline DiscoveryMap& operator = (DiscoveryMap const &dm) { throw std::runtime_error("[ERROR] Cannot reassign a DiscoveryMap object. Do NOT use the '=' operator."); };
+            inline DiscoveryMap& operator = (DiscoveryMap &&dm) { throw std::runtime_error("[ERROR] Cannot reassign a DiscoveryMap object. Do NOT use the '=' operator."); };
+
+            // Stop drawing the map before freeing it (see Discovery::setActive).
+            inline ~DiscoveryMap() { delete[] bits; };
+
+            // * ====================
+            // * Normal Functions
+            // * ====================
+
+            // Cover width x height cells of cellSize world units starting at origin. Everything starts hidden.
+            void init(glm::vec2 const &origin, float cellSize, int width, int height);
+
+            inline bool get(int x, int y) const { return (bits[(y*width + x) >> 6] >> ((y*width + x) & 63)) & 1; };
+
+            // Positions outside of the map count as revealed.
+            inline bool isRevealed(glm::vec2 const &pos) const {
+                int x = (int) std::floor((pos.x - origin.x)/cellSize), y = (int) std::floor((pos.y - origin.y)/cellSize);
+                return x < 0 || y < 0 || x >= width || y >= height || get(x, y);
+            };
+
+            // Reveal every cell whose center is within radius of center.
+            void reveal(glm::vec2 const &center, float radius);
+
+            // Reveal every cell touching the rectangle.
+            void revealRect(glm::vec2 const &min, glm::vec2 const &max);
+
+            // Hide everything again.
+            void clear();
+
+            inline void markDirty(int x0, int y0, int x1, int y1) {
+                if (x0 < dirtyX0) { dirtyX0 = x0; }
+                if (y0 < dirtyY0) { dirtyY0 = y0; }
+                if (x1 > dirtyX1) { dirtyX1 = x1; }
+                if (y1 > dirtyY1) { dirtyY1 = y1; }
+            };
+
+            inline void markClean() {
+                dirtyX0 = width;
+                dirtyY0 = height;
+                dirtyX1 = dirtyY1 = -1;
+            };
+    };
+
+    // Fog of war over the areas of the active room that have not been revealed.
+    // The fog is applied in default.glsl from a single channel texture mirroring the room's DiscoveryMap, so it costs no extra draws.
+    namespace Discovery {
+        // * Main thread.
+        extern DiscoveryMap* active; // nullptr = no fog
+        extern bool enabled;
+        extern glm::vec3 fogColor;
+        extern bool changed; // the fog looks different since it was last captured
+
+        // * Fog texture (created by the main context and read by the render thread).
+        extern unsigned int texID;
+        extern int texWidth, texHeight;
+        extern unsigned char* texels; // scratch space the bits are expanded into before uploading
+        extern bool started;
+
+        // * What the render thread draws with (only used from the render thread).
+        extern bool fogActive;
+        extern glm::vec2 fogOrigin, fogSize;
+        extern glm::vec3 fogDrawColor;
+
+        // Must be called from the main context.
+        void start();
+
+        // Draw the fog for a room's map. The whole map is uploaded the next time upload() is called.
+        inline void setActive(DiscoveryMap* map) {
+            active = map;
+            changed = 1;
+            if (map) { map->markDirty(0, 0, map->width - 1, map->height - 1); }
+        };
+
+        inline void setEnabled(bool enable) {
+            if (enabled == enable) { return; }
+            enabled = enable;
+            changed = 1;
+        };
+
+        // Mirror the cells of the active map that changed into the fog texture.
+        // Call once per frame while the render thread is not drawing.
+        void upload();
+
+        // * Render thread.
+
+        inline void use(bool fog, glm::vec2 const &origin, glm::vec2 const &size, glm::vec3 const &color) {
+            fogActive = fog;
+            fogOrigin = origin;
+            fogSize = size;
+            fogDrawColor = color;
+        };
+
+        // Bind the fog for a shader that is already in use.
+        inline void bind(Shader const &shader) {
+            shader.uploadInt("uFog", fogActive);
+            if (!fogActive) { return; }
+
+            GLState::bindTexture(DISCOVERY_TEX_SLOT, GL_TEXTURE_2D, texID);
+            shader.uploadInt("uDiscovery", DISCOVERY_TEX_SLOT);
+            shader.uploadVec2("uFogOrigin", fogOrigin);
+            shader.uploadVec2("uFogSize", fogSize);
+            shader.uploadVec3("uFogColor", fogDrawColor);
+        };
+
+        void destroy();
+    }
+}
@@ -8,17 +8,34 @@ namespace Dralgeer {
     class GameViewWindow {
         private:
             float leftX, rightX, topY, bottomY;
+            int viewWidth = 1, viewHeight = 1; // size of the image in framebuffer pixels
             bool imGuiSetup = 1;
             bool isPlaying = 0;
+            bool visible = 1; // the window is not collapsed or hidden behind another tab
 
             inline ImVec2 getLargestSize() const;
             inline ImVec2 getCenteredPos(ImVec2 const &size) const;
 
         public:
-            void imGui(unsigned int frameBufferTexID);
+            void imGui(FrameBuffer const &frameBuffer);
             inline bool getWantCaptureMouse() const {
                 return MouseListener::mX >= leftX && MouseListener::mX <= rightX && MouseListener::mY >= bottomY && MouseListener::mY <= topY;
             };
+
+            inline bool isVisible() const { return visible; };
+
+            // Size the scene has to be rendered at to fill the viewport pixel for pixel.
+            inline int getViewWidth() const { return viewWidth; };
+            inline int getViewHeight() const { return viewHeight; };
+    };
+
+    // Counters of the last frame the render thread drew, graphs of the latest frames (to spot spikes), and GPU memory in use.
+    class RenderStatsWindow {
+        private:
+            bool imGuiSetup = 1;
+
+        public:
+            void imGui();
     };
 
     class PropertiesWindow {
@@ -3,15 +3,34 @@
 #include "texture.h"
 
 namespace Dralgeer {
+    // Render target for a scene.
+    // Only the bottom left width x height region of the texture is drawn to so the render size can change every frame for free. The
+    // texture is only reallocated when it has to grow.
     class FrameBuffer {
         private:
             unsigned int fboID, rboID;
             Texture tex;
+            int width, height; // size of the region rendered to
 
         public:
             FrameBuffer() {};
             void init(int width, int height);
+
+            // Change the size of the region rendered to.
+            // Returns 1 if the texture and render buffer had to be reallocated (which is when anything attached to them must be reattached).
+            bool resize(int width, int height);
+
+            inline unsigned int getID() const { return fboID; };
             inline unsigned int getTextureID() const { return tex.texID; };
+            inline unsigned int getRenderBufferID() const { return rboID; };
+
+            inline int getWidth() const { return width; };
+            inline int getHeight() const { return height; };
+            inline int getTextureWidth() const { return tex.width; };
+            inline int getTextureHeight() const { return tex.height; };
+
+            // Top right corner of the region rendered to in texture coordinates.
+            inline glm::vec2 getMaxUV() const { return glm::vec2((float) width/tex.width, (float) height/tex.height); };
 
             inline void bind() const {
                 glBindFramebuffer(GL_FRAMEBUFFER, fboID);
@@ -24,7 +43,7 @@ namespace Dralgeer {
             };
 
             ~FrameBuffer() {
-                glDeleteRenderbuffers(1, &rboID);
+                GPU::deleteRenderbuffer(rboID);
                 glDeleteFramebuffers(1, &fboID);
             };
     };
@@ -39,6 +58,9 @@ namespace Dralgeer {
             inline PickingTexture() {};
             void init(int width, int height);
 
+            inline unsigned int getTextureID() const { return pTexID; };
+            inline unsigned int getDepthTextureID() const { return depthTexID; };
+
             inline int readPixel(int x, int y) const {
                 glBindFramebuffer(GL_FRAMEBUFFER, fboID);
                 glReadBuffer(GL_COLOR_ATTACHMENT0);
@@ -55,8 +77,8 @@ namespace Dralgeer {
 
             inline ~PickingTexture() {
                 glDeleteFramebuffers(1, &fboID);
-                glDeleteTextures(1, &pTexID);
-                glDeleteTextures(1, &depthTexID);
+                GPU::deleteTextures(1, &pTexID);
+                GPU::deleteTextures(1, &depthTexID);
             };
     };  
 }
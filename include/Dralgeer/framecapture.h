@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include "framebuffer.h"
+
+namespace Dralgeer {
+    // Saves frames of the scene as PNGs without stalling (for golden images, bug reports, and looking into performance problems).
+    // A captured frame is copied into one of a ring of pixel buffers on the GPU and only read back once its fence has passed a later
+    // frame, so the main thread never waits on the GPU. The PNGs are encoded on a worker thread.
+    // * Everything here must be called from the main thread with the window's context current.
+    namespace FrameCapture {
+        extern int every; // frames between captures while recording (0 = not recording)
+        extern std::string prefix; // recorded frames are saved as <prefix>_<frame>.png
+
+        // Start the encoder thread.
+        void start();
+
+        // Save the next frame drawn to path.
+        void captureFrame(std::string const &path);
+
+        // Save every nth frame drawn until stopRecording() is called.
+        inline void startRecording(int n, std::string const &filePrefix) {
+            every = n > 0 ? n : 1;
+            prefix = filePrefix;
+        };
+
+        inline void stopRecording() { every = 0; };
+        inline bool isRecording() { return every > 0; };
+
+        // Copy the frame just drawn (if it is due) and hand any copies that have finished to the encoder.
+        // Call once per frame after the render thread is done with the framebuffer and before it is resized.
+        // newFrame = the render thread drew a frame since the last call
+        void update(FrameBuffer const &frameBuffer, bool newFrame);
+
+        // Finish every capture still in flight and stop the encoder.
+        void destroy();
+    }
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <functional>
+#include <stdexcept>
+#include "gpu.h"
+
+namespace Dralgeer {
+    // Render target a pass can draw to or read from.
+    struct FrameResource {
+        char const* name;
+        unsigned int fboID = 0, texID = 0;
+        int width, height; // region that is drawn to
+        GLenum format = 0; // transient targets only
+        bool imported; // owned by someone else (otherwise it is a transient target the graph hands out for the frame)
+        bool consumed; // imported targets only -- something outside the graph reads it this frame
+
+        // * Filled in while the graph is executed.
+        GLbitfield clearBits = 0; // merged clears from every pass that writes it
+        float clearColor[4];
+        int firstWriter = -1, lastUser = -1; // first and last live pass that touches it
+        int pooled = -1; // transient targets only -- spot in the pool backing it
+        bool needed = 0;
+    };
+
+    struct FramePass {
+        char const* name;
+        std::function<void()> execute;
+        int reads[FRAME_GRAPH_MAX_PASS_IO];
+        int numReads = 0;
+        int writes[FRAME_GRAPH_MAX_PASS_IO];
+        GLbitfield clearBits[FRAME_GRAPH_MAX_PASS_IO]; // clears the pass wants for each write
+        float clearColors[FRAME_GRAPH_MAX_PASS_IO][4];
+        int numWrites = 0;
+        bool live = 0;
+
+        // Read a resource written by an earlier pass.
+        inline FramePass& read(int resource) {
+            reads[numReads++] = resource;
+            return *this;
+        };
+
+        // Draw to a resource. Passes are drawn to their first write.
+        // The clear is merged with every other pass's clear of the resource into one clear before its first live writer.
+        inline FramePass& write(int resource, GLbitfield clear = 0, float r = 0.0f, float g = 0.0f, float b = 0.0f, float a = 0.0f) {
+            writes[numWrites] = resource;
+            clearBits[numWrites] = clear;
+            clearColors[numWrites][0] = r;
+            clearColors[numWrites][1] = g;
+            clearColors[numWrites][2] = b;
+            clearColors[numWrites][3] = a;
+            ++numWrites;
+            return *this;
+        };
+    };
+
+    struct PassTiming {
+        char const* name;
+        float gpuTime; // ms (negative = culled)
+    };
+
+    // Render thread's passes for a frame.
+    // Passes are added every frame in the order they would be drawn along with the targets they read and write. When executed,
+    // passes that do not lead to a consumed target are culled, each target is cleared once with the clears of every pass drawing to it
+    // merged, and transient targets are handed out of a pool so ones with the same size and format are reused by later passes and
+    // frames. Each pass is timed on the GPU.
+    class FrameGraph {
+        private:
+            FrameResource resources[FRAME_GRAPH_MAX_RESOURCES];
+            int numResources = 0;
+            FramePass passes[FRAME_GRAPH_MAX_PASSES];
+            int numPasses = 0;
+
+            // * Pool behind the transient targets (kept between frames).
+            struct PooledTarget {
+                unsigned int fboID, texID;
+                int width, height;
+                GLenum format;
+                bool inUse;
+                int lastUsed; // frame it was last handed out
+            };
+
+            PooledTarget pool[FRAME_GRAPH_MAX_RESOURCES];
+            int poolSize = 0;
+
+            // * GPU timing.
+            // ? Like the RenderThread's frame timer, each frame's queries are read RENDER_TIMER_QUERIES frames later so it never stalls.
+            unsigned int queries[RENDER_TIMER_QUERIES][FRAME_GRAPH_MAX_PASSES];
+            char const* queryNames[RENDER_TIMER_QUERIES][FRAME_GRAPH_MAX_PASSES];
+            int numQueries[RENDER_TIMER_QUERIES] = {0};
+            PassTiming measured[FRAME_GRAPH_MAX_PASSES]; // live passes of the latest frame measured
+            int numMeasured = 0;
+            int frame = 0;
+            bool started = 0;
+            bool failed = 0; // a transient target could not be made (only logged the first time)
+
+            int acquire(int width, int height, GLenum format); // returns -1 if no target could be made
+            void release(int resource);
+            void cull();
+            void readTimings(int slot);
+
+        public:
+            // Every pass of the last frame executed with its latest measured time (culled ones included).
+            PassTiming timings[FRAME_GRAPH_MAX_PASSES];
+            int numTimings = 0;
+
+            float gpuTime = 0.0f; // ms summed over the live passes of the latest frame measured (0 = nothing new was measured)
+
+            inline FrameGraph() {};
+
+            // ? Do not allow for reassignment or construction of a FrameGraph from another FrameGraph
+
+            inline FrameGraph(FrameGraph const &fg) { throw std::runtime_error("[ERROR] Cannot constructor a FrameGraph from another FrameGraph."); };
+            inline FrameGraph(FrameGraph &&fg) { throw std::runtime_error("[ERROR] Cannot constructor a FrameGraph from another FrameGraph."); };
+            inline FrameGraph& operator = (FrameGraph const &fg) { throw std::runtime_error("[ERROR] Cannot reassign a FrameGraph object. Do NOT use the '=' operator."); };
+            inline FrameGraph& operator = (FrameGraph &&fg) { throw std::runtime_error("[ERROR] Cannot reassign a FrameGraph object. Do NOT use the '=' operator."); };
+
+            // * ====================
+            // * Normal Functions
+            // * ====================
+
+            // Create the GPU objects. Must be called from the context the passes are drawn with.
+            void start();
+
+            // Target owned by someone else. consumed = something outside the graph reads it this frame.
+            int import(char const* name, unsigned int fboID, unsigned int texID, int width, int height, bool consumed);
+
+            // Target that only lives for the frame.
+            int transient(char const* name, int width, int height, GLenum format);
+
+            // Add a pass (declare its reads and writes on the result).
+            FramePass& addPass(char const* name, std::function<void()> execute);
+
+            // Texture of a resource. Only valid while the graph is executing.
+            inline unsigned int getTexture(int resource) const { return resources[resource].texID; };
+
+            // Cull, clear, and draw every pass added since the last call.
+            void execute();
+
+            // Free the GPU objects. Must be called from the context that called start().
+            void stop();
+    };
+}
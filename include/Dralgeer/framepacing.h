@@ -0,0 +1,53 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+#include "constants.h"
+
+namespace Dralgeer {
+    enum PacingMode {
+        PACING_VSYNC, // wait for the vertical blank every frame (smoothest but adds up to a refresh of latency)
+        PACING_ADAPTIVE, // v-sync unless the frame is late, in which case it tears instead of waiting a whole refresh
+        PACING_UNCAPPED, // present as fast as possible (lowest latency, tears, and keeps the CPU and GPU at 100%)
+        PACING_LIMITED // no v-sync, but sleep and then spin until the target frame rate's deadline before presenting
+    };
+
+    // How the main loop presents frames and how long each part of a frame took.
+    namespace FramePacing {
+        // * Every time is in ms.
+        struct FrameTiming {
+            float frameTime; // since the last present
+            float cpuTime; // from the start of the frame (after waiting for events) to right before the limiter and present
+            float presentTime; // spent in the limiter and the swap
+            float inputLatency; // from the oldest input handled to the present that first showed its result (negative = no input)
+        };
+
+        extern PacingMode mode;
+        extern float targetFPS; // only used by PACING_LIMITED
+        extern bool adaptiveSupported; // the driver can do adaptive v-sync (otherwise PACING_ADAPTIVE falls back to v-sync)
+
+        extern FrameTiming history[FRAME_PACING_HISTORY]; // ring buffer with the newest frame at index - 1
+        extern int index;
+        extern int numFrames; // frames in the history so far (it fills from the start before wrapping around)
+        extern double deadline; // time the limiter last presented at (s)
+
+        // Check what the driver supports and apply the mode. Call with the window's context current.
+        void init(PacingMode mode = PACING_VSYNC);
+
+        // Switch modes. Call with the window's context current.
+        void setMode(PacingMode mode);
+
+        // Block until it is time to present. Does nothing unless the mode is PACING_LIMITED.
+        void limit();
+
+        inline void record(FrameTiming const &timing) {
+            history[index] = timing;
+            index = (index + 1) % FRAME_PACING_HISTORY;
+            if (numFrames < FRAME_PACING_HISTORY) { ++numFrames; }
+        };
+
+        inline FrameTiming const& latest() { return history[(index + FRAME_PACING_HISTORY - 1) % FRAME_PACING_HISTORY]; };
+
+        // Average of the last FRAME_PACING_HISTORY frames or as many as have been recorded (only frames with input count towards the latency).
+        FrameTiming average();
+    }
+}
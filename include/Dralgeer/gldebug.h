@@ -0,0 +1,179 @@
+#pragma once
+
+#include <GL/glew.h>
+
+// Debug builds trace the GL calls the engine makes unless DRALGEER_NO_GL_DEBUG is defined.
+// Release builds (-DNDEBUG) make the raw calls and everything in GLDebug does nothing.
+#if !defined(NDEBUG) && !defined(DRALGEER_NO_GL_DEBUG)
+    #define DRALGEER_GL_DEBUG
+#endif
+
+namespace Dralgeer {
+    // Validation and call tracing over the GL calls the engine makes.
+    // In debug builds the calls below are swapped for wrappers (by the macros at the bottom of this file) that count them per frame and
+    // keep track of every live buffer, texture, VAO, framebuffer, and renderbuffer along with where it was made, so anything still alive
+    // at shutdown can be reported. Errors are reported through KHR_debug when the driver has it and glGetError once per frame when not.
+    // * Only files that include this header (glstate.h does) are traced. ImGui's backend loads GL itself so it is not.
+    namespace GLDebug {
+        enum CallType {
+            CALL_DRAW,
+            CALL_UPLOAD, // buffer and texture data
+            CALL_BIND,
+            CALL_CREATE,
+            CALL_DELETE,
+            NUM_CALL_TYPES
+        };
+
+        enum ObjectType {
+            OBJECT_BUFFER,
+            OBJECT_TEXTURE,
+            OBJECT_VERTEX_ARRAY, // per context
+            OBJECT_FRAMEBUFFER, // per context
+            OBJECT_RENDERBUFFER,
+            NUM_OBJECT_TYPES
+        };
+
+        // GL calls made by a thread in a frame.
+        struct CallCounts {
+            int calls[NUM_CALL_TYPES] = {0};
+        };
+
+        #ifdef DRALGEER_GL_DEBUG
+
+            extern thread_local CallCounts counts; // current frame
+            extern thread_local CallCounts lastFrame;
+
+            // Install the KHR_debug callback for the current context (each context needs its own).
+            // Call once after the context is made current (and GLEW is initialized).
+            void init();
+
+            // Finish the current thread's frame (and check for errors if KHR_debug is not available).
+            void endFrame();
+
+            // Number of objects of a type that are still alive.
+            int liveCount(ObjectType type);
+
+            // Print every object that is still alive grouped by where it was made. Call at shutdown once everything should be freed.
+            void report();
+
+            inline void count(CallType type) { ++counts.calls[type]; };
+
+            void created(ObjectType type, GLsizei n, GLuint const* ids, char const* file, int line);
+            void deleted(ObjectType type, GLsizei n, GLuint const* ids);
+
+            // ? These call through to the real functions (passed in so the macros below do not expand into themselves).
+
+            template <typename Fn>
+            inline void gen(Fn fn, ObjectType type, GLsizei n, GLuint* ids, char const* file, int line) {
+                fn(n, ids);
+                count(CALL_CREATE);
+                created(type, n, ids, file, line);
+            };
+
+            template <typename Fn>
+            inline void create(Fn fn, GLenum target, GLsizei n, GLuint* ids, char const* file, int line) {
+                fn(target, n, ids);
+                count(CALL_CREATE);
+                created(OBJECT_TEXTURE, n, ids, file, line);
+            };
+
+            template <typename Fn>
+            inline void destroy(Fn fn, ObjectType type, GLsizei n, GLuint const* ids) {
+                deleted(type, n, ids);
+                count(CALL_DELETE);
+                fn(n, ids);
+            };
+
+        #else
+
+            inline void init() {};
+            inline void endFrame() {};
+            inline int liveCount(ObjectType) { return 0; };
+            inline void report() {};
+
+        #endif
+    }
+}
+
+#ifdef DRALGEER_GL_DEBUG
+    // * ===================
+    // * Traced Calls
+    // * ===================
+
+    // ? A macro's name is not expanded again inside of itself, so the GL 1.1 functions (which GLEW declares directly) are called by name.
+    // ? The rest are GLEW function pointers that are called through GLEW_GET_FUN after their macros are replaced.
+
+    #define DRALGEER_GL_COUNT(type, call) (::Dralgeer::GLDebug::count(::Dralgeer::GLDebug::type), call)
+
+    // * Object lifetimes.
+
+    #undef glGenBuffers
+    #undef glCreateBuffers
+    #undef glGenVertexArrays
+    #undef glCreateVertexArrays
+    #undef glGenFramebuffers
+    #undef glCreateFramebuffers
+    #undef glGenRenderbuffers
+    #undef glCreateRenderbuffers
+    #undef glCreateTextures
+    #undef glDeleteBuffers
+    #undef glDeleteVertexArrays
+    #undef glDeleteFramebuffers
+    #undef glDeleteRenderbuffers
+
+    #define glGenBuffers(n, ids) ::Dralgeer::GLDebug::gen(GLEW_GET_FUN(__glewGenBuffers), ::Dralgeer::GLDebug::OBJECT_BUFFER, n, ids, __FILE__, __LINE__)
+    #define glCreateBuffers(n, ids) ::Dralgeer::GLDebug::gen(GLEW_GET_FUN(__glewCreateBuffers), ::Dralgeer::GLDebug::OBJECT_BUFFER, n, ids, __FILE__, __LINE__)
+    #define glGenTextures(n, ids) ::Dralgeer::GLDebug::gen(glGenTextures, ::Dralgeer::GLDebug::OBJECT_TEXTURE, n, ids, __FILE__, __LINE__)
+    #define glCreateTextures(target, n, ids) ::Dralgeer::GLDebug::create(GLEW_GET_FUN(__glewCreateTextures), target, n, ids, __FILE__, __LINE__)
+    #define glGenVertexArrays(n, ids) ::Dralgeer::GLDebug::gen(GLEW_GET_FUN(__glewGenVertexArrays), ::Dralgeer::GLDebug::OBJECT_VERTEX_ARRAY, n, ids, __FILE__, __LINE__)
+    #define glCreateVertexArrays(n, ids) ::Dralgeer::GLDebug::gen(GLEW_GET_FUN(__glewCreateVertexArrays), ::Dralgeer::GLDebug::OBJECT_VERTEX_ARRAY, n, ids, __FILE__, __LINE__)
+    #define glGenFramebuffers(n, ids) ::Dralgeer::GLDebug::gen(GLEW_GET_FUN(__glewGenFramebuffers), ::Dralgeer::GLDebug::OBJECT_FRAMEBUFFER, n, ids, __FILE__, __LINE__)
+    #define glCreateFramebuffers(n, ids) ::Dralgeer::GLDebug::gen(GLEW_GET_FUN(__glewCreateFramebuffers), ::Dralgeer::GLDebug::OBJECT_FRAMEBUFFER, n, ids, __FILE__, __LINE__)
+    #define glGenRenderbuffers(n, ids) ::Dralgeer::GLDebug::gen(GLEW_GET_FUN(__glewGenRenderbuffers), ::Dralgeer::GLDebug::OBJECT_RENDERBUFFER, n, ids, __FILE__, __LINE__)
+    #define glCreateRenderbuffers(n, ids) ::Dralgeer::GLDebug::gen(GLEW_GET_FUN(__glewCreateRenderbuffers), ::Dralgeer::GLDebug::OBJECT_RENDERBUFFER, n, ids, __FILE__, __LINE__)
+
+    #define glDeleteBuffers(n, ids) ::Dralgeer::GLDebug::destroy(GLEW_GET_FUN(__glewDeleteBuffers), ::Dralgeer::GLDebug::OBJECT_BUFFER, n, ids)
+    #define glDeleteTextures(n, ids) ::Dralgeer::GLDebug::destroy(glDeleteTextures, ::Dralgeer::GLDebug::OBJECT_TEXTURE, n, ids)
+    #define glDeleteVertexArrays(n, ids) ::Dralgeer::GLDebug::destroy(GLEW_GET_FUN(__glewDeleteVertexArrays), ::Dralgeer::GLDebug::OBJECT_VERTEX_ARRAY, n, ids)
+    #define glDeleteFramebuffers(n, ids) ::Dralgeer::GLDebug::destroy(GLEW_GET_FUN(__glewDeleteFramebuffers), ::Dralgeer::GLDebug::OBJECT_FRAMEBUFFER, n, ids)
+    #define glDeleteRenderbuffers(n, ids) ::Dralgeer::GLDebug::destroy(GLEW_GET_FUN(__glewDeleteRenderbuffers), ::Dralgeer::GLDebug::OBJECT_RENDERBUFFER, n, ids)
+
+    // * Draws.
+
+    #undef glDrawArraysInstanced
+    #undef glDrawElementsInstanced
+
+    #define glDrawArrays(...) DRALGEER_GL_COUNT(CALL_DRAW, glDrawArrays(__VA_ARGS__))
+    #define glDrawElements(...) DRALGEER_GL_COUNT(CALL_DRAW, glDrawElements(__VA_ARGS__))
+    #define glDrawArraysInstanced(...) DRALGEER_GL_COUNT(CALL_DRAW, GLEW_GET_FUN(__glewDrawArraysInstanced)(__VA_ARGS__))
+    #define glDrawElementsInstanced(...) DRALGEER_GL_COUNT(CALL_DRAW, GLEW_GET_FUN(__glewDrawElementsInstanced)(__VA_ARGS__))
+
+    // * Uploads.
+
+    #undef glBufferData
+    #undef glBufferSubData
+    #undef glNamedBufferData
+    #undef glNamedBufferSubData
+    #undef glTextureSubImage2D
+
+    #define glBufferData(...) DRALGEER_GL_COUNT(CALL_UPLOAD, GLEW_GET_FUN(__glewBufferData)(__VA_ARGS__))
+    #define glBufferSubData(...) DRALGEER_GL_COUNT(CALL_UPLOAD, GLEW_GET_FUN(__glewBufferSubData)(__VA_ARGS__))
+    #define glNamedBufferData(...) DRALGEER_GL_COUNT(CALL_UPLOAD, GLEW_GET_FUN(__glewNamedBufferData)(__VA_ARGS__))
+    #define glNamedBufferSubData(...) DRALGEER_GL_COUNT(CALL_UPLOAD, GLEW_GET_FUN(__glewNamedBufferSubData)(__VA_ARGS__))
+    #define glTexImage2D(...) DRALGEER_GL_COUNT(CALL_UPLOAD, glTexImage2D(__VA_ARGS__))
+    #define glTexSubImage2D(...) DRALGEER_GL_COUNT(CALL_UPLOAD, glTexSubImage2D(__VA_ARGS__))
+    #define glTextureSubImage2D(...) DRALGEER_GL_COUNT(CALL_UPLOAD, GLEW_GET_FUN(__glewTextureSubImage2D)(__VA_ARGS__))
+
+    // * Binds.
+
+    #undef glUseProgram
+    #undef glBindVertexArray
+    #undef glBindBuffer
+    #undef glBindFramebuffer
+
+    #define glUseProgram(...) DRALGEER_GL_COUNT(CALL_BIND, GLEW_GET_FUN(__glewUseProgram)(__VA_ARGS__))
+    #define glBindVertexArray(...) DRALGEER_GL_COUNT(CALL_BIND, GLEW_GET_FUN(__glewBindVertexArray)(__VA_ARGS__))
+    #define glBindBuffer(...) DRALGEER_GL_COUNT(CALL_BIND, GLEW_GET_FUN(__glewBindBuffer)(__VA_ARGS__))
+    #define glBindFramebuffer(...) DRALGEER_GL_COUNT(CALL_BIND, GLEW_GET_FUN(__glewBindFramebuffer)(__VA_ARGS__))
+    #define glBindTexture(...) DRALGEER_GL_COUNT(CALL_BIND, glBindTexture(__VA_ARGS__))
+#endif
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "gldebug.h"
+#include "constants.h"
+#include "camera.h"
+
+namespace Dralgeer {
+    // Thin cache over the GL binding state so redundant binds are skipped.
+    // Binding state belongs to a context and each thread has at most one context current, so the cache is per thread.
+    // * Every program, VAO, texture, and buffer bind should go through here or the cache will go stale.
+    // * Element array buffer binds are part of the VAO so those are left alone.
+    namespace GLState {
+        // Number of binds made and skipped.
+        struct Counters {
+            int programBinds = 0, programSkips = 0;
+            int vaoBinds = 0, vaoSkips = 0;
+            int textureBinds = 0, textureSkips = 0;
+            int bufferBinds = 0, bufferSkips = 0;
+        };
+
+        struct State {
+            unsigned int program = 0;
+            unsigned int vao = 0;
+            unsigned int arrayBuffer = 0, uniformBuffer = 0, textureBuffer = 0;
+
+            int activeUnit = 0;
+            unsigned int textures[GL_STATE_TEXTURE_UNITS] = {0}; // GL_TEXTURE_2D bound to each unit
+            unsigned int bufferTextures[GL_STATE_TEXTURE_UNITS] = {0}; // GL_TEXTURE_BUFFER bound to each unit
+
+            unsigned int cameraUBO = 0;
+
+            Counters counters; // counters for the current frame
+            Counters lastFrame; // counters for the last finished frame
+        };
+
+        extern thread_local State state;
+
+        // * ===================
+        // * Binds
+        // * ===================
+
+        inline void useProgram(unsigned int id) {
+            if (state.program == id) { ++state.counters.programSkips; return; }
+
+            glUseProgram(id);
+            state.program = id;
+            ++state.counters.programBinds;
+        };
+
+        inline void bindVertexArray(unsigned int id) {
+            if (state.vao == id) { ++state.counters.vaoSkips; return; }
+
+            glBindVertexArray(id);
+            state.vao = id;
+            ++state.counters.vaoBinds;
+        };
+
+        inline void activeTexture(int unit) {
+            if (state.activeUnit == unit) { return; }
+
+            glActiveTexture(GL_TEXTURE0 + unit);
+            state.activeUnit = unit;
+        };
+
+        // Bind a texture to the given unit. target should be GL_TEXTURE_2D or GL_TEXTURE_BUFFER.
+        inline void bindTexture(int unit, GLenum target, unsigned int id) {
+            unsigned int &bound = target == GL_TEXTURE_BUFFER ? state.bufferTextures[unit] : state.textures[unit];
+            if (bound == id) { ++state.counters.textureSkips; return; }
+
+            activeTexture(unit);
+            glBindTexture(target, id);
+            bound = id;
+            ++state.counters.textureBinds;
+        };
+
+        // Bind a texture to the active unit.
+        inline void bindTexture(GLenum target, unsigned int id) { bindTexture(state.activeUnit, target, id); };
+
+        inline void bindBuffer(GLenum target, unsigned int id) {
+            unsigned int* bound = nullptr;
+            if (target == GL_ARRAY_BUFFER) { bound = &state.arrayBuffer; }
+            else if (target == GL_UNIFORM_BUFFER) { bound = &state.uniformBuffer; }
+            else if (target == GL_TEXTURE_BUFFER) { bound = &state.textureBuffer; }
+
+            if (bound && *bound == id) { ++state.counters.bufferSkips; return; }
+
+            glBindBuffer(target, id);
+            if (bound) { *bound = id; }
+            ++state.counters.bufferBinds;
+        };
+
+        // * ===================
+        // * Deletion
+        // * ===================
+
+        // ? Deleting an object unbinds it from the current context, so call these after deleting one to keep the cache in sync.
+
+        inline void forgetProgram(unsigned int id) { if (state.program == id) { state.program = ~0u; }};
+
+        inline void forgetVertexArray(unsigned int id) { if (state.vao == id) { state.vao = 0; }};
+
+        inline void forgetBuffer(unsigned int id) {
+            if (state.arrayBuffer == id) { state.arrayBuffer = 0; }
+            if (state.uniformBuffer == id) { state.uniformBuffer = 0; }
+            if (state.textureBuffer == id) { state.textureBuffer = 0; }
+        };
+
+        inline void forgetTexture(unsigned int id) {
+            for (int i = 0; i < GL_STATE_TEXTURE_UNITS; ++i) {
+                if (state.textures[i] == id) { state.textures[i] = 0; }
+                if (state.bufferTextures[i] == id) { state.bufferTextures[i] = 0; }
+            }
+        };
+
+        // * ===================
+        // * Camera
+        // * ===================
+
+        // Upload the camera to the UBO every shader's Camera block reads from.
+        // Call once per frame (or whenever the camera being drawn with changes).
+        inline void setCamera(Camera const &cam) {
+            if (!state.cameraUBO) {
+                glGenBuffers(1, &state.cameraUBO);
+                bindBuffer(GL_UNIFORM_BUFFER, state.cameraUBO);
+                glBufferData(GL_UNIFORM_BUFFER, CAMERA_UBO_SIZE_BYTES, NULL, GL_DYNAMIC_DRAW);
+                glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_UBO_BINDING, state.cameraUBO);
+            }
+
+            // std140 lays mat4s out back to back so the block can be filled in a single upload
+            glm::mat4 data[4] = {cam.proj, cam.view, cam.invProj, cam.invView};
+
+            bindBuffer(GL_UNIFORM_BUFFER, state.cameraUBO);
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, CAMERA_UBO_SIZE_BYTES, data);
+        };
+
+        // * ===================
+        // * Frame Stuff
+        // * ===================
+
+        inline void endFrame() {
+            state.lastFrame = state.counters;
+            state.counters = Counters();
+        };
+
+        // Free the current thread's GL objects. Must be called from the thread that made them.
+        inline void destroy() {
+            if (!state.cameraUBO) { return; }
+
+            glDeleteBuffers(1, &state.cameraUBO);
+            forgetBuffer(state.cameraUBO);
+            state.cameraUBO = 0;
+        };
+    }
+}
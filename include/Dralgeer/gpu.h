@@ -0,0 +1,237 @@
+#pragma once
+
+#include "glstate.h"
+#include "renderstats.h"
+
+namespace Dralgeer {
+    // Thin layer for making and editing GPU resources without binding them.
+    // With GL 4.5 (or ARB_direct_state_access) objects are edited by name, so setting one up never disturbs what is bound for drawing
+    // and edits made every frame skip their bind. Otherwise it falls back to the GL 3.3 bind-to-edit path through GLState.
+    // * Objects made here are still bound for drawing through GLState like any other.
+    // * Their sizes and the data sent to them are tracked by RenderStats, so free them with the delete functions here.
+    namespace GPU {
+        extern bool dsa; // objects are edited by name
+
+        // Pick the implementation. Call once after GLEW is initialized.
+        void init();
+
+        // * ===================
+        // * Buffers
+        // * ===================
+
+        // ? target is only used by the fallback (the buffer is bound to it to be edited).
+        // ? Binding an element array buffer would change the bound VAO, so the fallback edits those through GL_ARRAY_BUFFER instead
+        // ? (buffers do not care which target they are filled through).
+
+        // Bind a buffer to edit it. Returns the target it was bound to.
+        inline GLenum bindForEdit(GLenum target, unsigned int id) {
+            if (target == GL_ELEMENT_ARRAY_BUFFER) { target = GL_ARRAY_BUFFER; }
+            GLState::bindBuffer(target, id);
+            return target;
+        };
+
+        inline unsigned int createBuffer(GLenum target, GLsizeiptr size, void const* data, GLenum usage) {
+            unsigned int id;
+
+            if (dsa) {
+                glCreateBuffers(1, &id);
+                glNamedBufferData(id, size, data, usage);
+            } else {
+                glGenBuffers(1, &id);
+                glBufferData(bindForEdit(target, id), size, data, usage);
+            }
+
+            RenderStats::setBufferSize(id, size);
+            if (data) { RenderStats::uploaded(size); }
+            return id;
+        };
+
+        // Reallocate (or orphan) a buffer's storage.
+        inline void bufferData(GLenum target, unsigned int id, GLsizeiptr size, void const* data, GLenum usage) {
+            RenderStats::setBufferSize(id, size);
+            if (data) { RenderStats::uploaded(size); }
+
+            if (dsa) { glNamedBufferData(id, size, data, usage); return; }
+            glBufferData(bindForEdit(target, id), size, data, usage);
+        };
+
+        inline void bufferSubData(GLenum target, unsigned int id, GLintptr offset, GLsizeiptr size, void const* data) {
+            RenderStats::uploaded(size);
+
+            if (dsa) { glNamedBufferSubData(id, offset, size, data); return; }
+            glBufferSubData(bindForEdit(target, id), offset, size, data);
+        };
+
+        inline void deleteBuffers(int n, unsigned int const* ids) {
+            glDeleteBuffers(n, ids);
+
+            for (int i = 0; i < n; ++i) {
+                GLState::forgetBuffer(ids[i]); // deleting a buffer unbinds it
+                RenderStats::freeBuffer(ids[i]);
+            }
+        };
+
+        // * ===================
+        // * Vertex Arrays
+        // * ===================
+
+        // A float attribute read from a single interleaved VBO. Attribute i goes to location i.
+        struct VertexAttribute {
+            int size; // floats
+            int offset; // bytes from the start of the vertex
+        };
+
+        // Make a VAO reading the attributes from vbo (and indices from ebo unless it is 0).
+        // The fallback leaves the VAO bound.
+        unsigned int createVertexArray(unsigned int vbo, unsigned int ebo, int stride, VertexAttribute const* attributes, int numAttributes);
+
+        // * ===================
+        // * Textures
+        // * ===================
+
+        // Make an empty 2D texture. Its storage is given with allocateTexture2D or storeTexture2D.
+        inline unsigned int createTexture2D() {
+            unsigned int id;
+
+            if (dsa) { glCreateTextures(GL_TEXTURE_2D, 1, &id); }
+            else {
+                glGenTextures(1, &id);
+                GLState::bindTexture(GL_TEXTURE_2D, id);
+            }
+
+            return id;
+        };
+
+        inline void textureParameter(unsigned int id, GLenum name, int value) {
+            if (dsa) { glTextureParameteri(id, name, value); return; }
+
+            GLState::bindTexture(GL_TEXTURE_2D, id);
+            glTexParameteri(GL_TEXTURE_2D, name, value);
+        };
+
+        // Filter and wrap modes in one go.
+        inline void textureSampling(unsigned int id, int filter, int wrap) {
+            textureParameter(id, GL_TEXTURE_MIN_FILTER, filter);
+            textureParameter(id, GL_TEXTURE_MAG_FILTER, filter);
+            textureParameter(id, GL_TEXTURE_WRAP_S, wrap);
+            textureParameter(id, GL_TEXTURE_WRAP_T, wrap);
+        };
+
+        // Give a texture storage that can be reallocated later (e.g. when a framebuffer grows).
+        // Mutable storage has no direct state access version, so this always binds.
+        inline void allocateTexture2D(unsigned int id, GLenum internalFormat, int width, int height, GLenum format, GLenum type, void const* data) {
+            long long bytes = RenderStats::textureBytes(internalFormat, width, height, 1);
+            RenderStats::setTextureSize(id, bytes);
+            if (data) { RenderStats::uploaded(bytes); }
+
+            GLState::bindTexture(GL_TEXTURE_2D, id);
+            glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, data);
+        };
+
+        // Give a texture storage that never changes size and fill it with data (if given).
+        // sizedFormat must be a sized internal format (e.g. GL_RGBA8) and levels includes the base level.
+        void storeTexture2D(unsigned int id, GLenum sizedFormat, int levels, int width, int height, GLenum format, GLenum type, void const* data);
+
+        inline void textureSubImage2D(unsigned int id, int x, int y, int width, int height, GLenum format, GLenum type, void const* data) {
+            RenderStats::uploaded((long long) RenderStats::pixelBytes(format, type) * width * height);
+
+            if (dsa) { glTextureSubImage2D(id, 0, x, y, width, height, format, type, data); return; }
+
+            GLState::bindTexture(GL_TEXTURE_2D, id);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, format, type, data);
+        };
+
+        inline void generateMipmap(unsigned int id) {
+            if (dsa) { glGenerateTextureMipmap(id); return; }
+
+            GLState::bindTexture(GL_TEXTURE_2D, id);
+            glGenerateMipmap(GL_TEXTURE_2D);
+        };
+
+        inline void deleteTextures(int n, unsigned int const* ids) {
+            glDeleteTextures(n, ids);
+
+            for (int i = 0; i < n; ++i) {
+                GLState::forgetTexture(ids[i]);
+                RenderStats::freeTexture(ids[i]);
+            }
+        };
+
+        // * ===================
+        // * Framebuffers
+        // * ===================
+
+        // ? The fallback binds the framebuffer to edit it and binds the default one back once it is done.
+        // ? Framebuffers are not shared between contexts, so make them on the context that draws with them.
+
+        inline unsigned int createFramebuffer() {
+            unsigned int id;
+            if (dsa) { glCreateFramebuffers(1, &id); }
+            else { glGenFramebuffers(1, &id); }
+            return id;
+        };
+
+        inline void framebufferTexture(unsigned int fbo, GLenum attachment, unsigned int texID) {
+            RenderStats::markTarget(texID);
+
+            if (dsa) { glNamedFramebufferTexture(fbo, attachment, texID, 0); return; }
+
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, texID, 0);
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        };
+
+        inline void framebufferRenderbuffer(unsigned int fbo, GLenum attachment, unsigned int rbo) {
+            if (dsa) { glNamedFramebufferRenderbuffer(fbo, attachment, GL_RENDERBUFFER, rbo); return; }
+
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, rbo);
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        };
+
+        // Pick the color attachment drawn to and read from (GL_NONE = none).
+        inline void framebufferBuffers(unsigned int fbo, GLenum draw, GLenum read) {
+            if (dsa) {
+                glNamedFramebufferDrawBuffer(fbo, draw);
+                glNamedFramebufferReadBuffer(fbo, read);
+                return;
+            }
+
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+            glDrawBuffer(draw);
+            glReadBuffer(read);
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        };
+
+        inline bool isFramebufferComplete(unsigned int fbo) {
+            if (dsa) { return glCheckNamedFramebufferStatus(fbo, GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE; }
+
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+            bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            return complete;
+        };
+
+        inline unsigned int createRenderbuffer() {
+            unsigned int id;
+            if (dsa) { glCreateRenderbuffers(1, &id); }
+            else { glGenRenderbuffers(1, &id); }
+            return id;
+        };
+
+        inline void renderbufferStorage(unsigned int rbo, GLenum format, int width, int height) {
+            RenderStats::setRenderbufferSize(rbo, RenderStats::textureBytes(format, width, height, 1));
+
+            if (dsa) { glNamedRenderbufferStorage(rbo, format, width, height); return; }
+
+            glBindRenderbuffer(GL_RENDERBUFFER, rbo);
+            glRenderbufferStorage(GL_RENDERBUFFER, format, width, height);
+            glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        };
+
+        inline void deleteRenderbuffer(unsigned int rbo) {
+            glDeleteRenderbuffers(1, &rbo);
+            RenderStats::freeRenderbuffer(rbo);
+        };
+    }
+}
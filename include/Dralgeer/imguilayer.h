@@ -14,10 +14,11 @@ namespace Dralgeer {
         public:
             PropertiesWindow propertiesWindow;
             GameViewWindow gameViewWindow;
+            RenderStatsWindow renderStatsWindow;
 
             ImGuiLayer() {};
             void init(GLFWwindow* window, PickingTexture* pickingTexture);
-            void update(float dt, void* currScene, ROOT_SCENE sceneType, unsigned int frameBufferTexID, int windowWidth, int windowHeight);
+            void update(float dt, void* currScene, ROOT_SCENE sceneType, FrameBuffer const &frameBuffer, int windowWidth, int windowHeight);
             void dispose() const;
     };
 }
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstring>
+#include "assetpool.h"
+#include "camera.h"
+
+namespace Dralgeer {
+    // 2D point lights.
+    // The lights are accumulated into a reduced resolution light map with a single full screen pass. The light map is split into tiles
+    // that each get a list of the lights touching them (culled on the CPU), so each pixel only evaluates the lights that can reach it.
+    // Sprites drawn with default.glsl are multiplied by the light map.
+    namespace Lighting {
+        struct PointLight {
+            glm::vec2 pos;
+            float radius; // the light falls off to nothing at this distance
+            float intensity;
+            glm::vec3 color;
+        };
+
+        // * Lights (set from the main thread).
+        // * These are unordered so removing a light moves the last one into its slot.
+        extern PointLight* lights;
+        extern int numLights;
+        extern int capacity;
+
+        extern bool enabled;
+        extern glm::vec3 ambient; // light every pixel gets
+        extern bool dirty; // the lights changed since they were last captured
+
+        // * Light map (only used from the render thread).
+        // * The texture and framebuffer behind it are handed out by the render thread's frame graph each frame.
+        extern unsigned int lightMap;
+        extern int sceneWidth, sceneHeight; // size of the region the light map covers
+        extern bool started, active; // active = the light map was rendered for the frame being drawn
+
+        // Returns the light's index.
+        inline int addLight(glm::vec2 const &pos, float radius, glm::vec3 const &color, float intensity = 1.0f) {
+            if (numLights == capacity) {
+                capacity *= 2;
+                PointLight* temp = new PointLight[capacity];
+                std::memcpy(temp, lights, numLights * sizeof(PointLight));
+
+                delete[] lights;
+                lights = temp;
+            }
+
+            lights[numLights] = {pos, radius, intensity, color};
+            dirty = 1;
+            return numLights++;
+        };
+
+        inline void setLight(int index, PointLight const &light) {
+            if (index < 0 || index >= numLights) { return; }
+
+            lights[index] = light;
+            dirty = 1;
+        };
+
+        // The last light takes the removed light's index.
+        inline void removeLight(int index) {
+            if (index < 0 || index >= numLights) { return; }
+
+            lights[index] = lights[--numLights];
+            dirty = 1;
+        };
+
+        inline void setAmbient(glm::vec3 const &color) {
+            ambient = color;
+            dirty = 1;
+        };
+
+        inline void clear() {
+            numLights = 0;
+            dirty = 1;
+        };
+
+        // Create the GPU objects. Must be called from the context the light map is drawn with.
+        // The shader must be lighting.glsl and outlive stop().
+        void start(Shader* lightingShader);
+
+        // Size of the light map for a scene of the given size.
+        inline void mapSize(int sceneWidth, int sceneHeight, int &width, int &height) {
+            width = (int) (sceneWidth * LIGHT_MAP_SCALE);
+            height = (int) (sceneHeight * LIGHT_MAP_SCALE);
+            if (width < 1) { width = 1; }
+            if (height < 1) { height = 1; }
+        };
+
+        // Cull the lights into tiles and render the light map for a scene of the given size.
+        // The camera UBO must already hold cam and the light map (mapWidth x mapHeight) must be bound as the target with its viewport set.
+        void render(PointLight const* lights, int numLights, glm::vec3 const &ambient, Camera const &cam, int sceneWidth, int sceneHeight,
+                unsigned int mapTexID, int mapWidth, int mapHeight);
+
+        // Do not light the frame being drawn.
+        inline void skip() { active = 0; };
+
+        // Bind the light map for a shader that is already in use.
+        inline void bind(Shader const &shader) {
+            shader.uploadInt("uLighting", active);
+            if (!active) { return; }
+
+            GLState::bindTexture(LIGHT_MAP_TEX_SLOT, GL_TEXTURE_2D, lightMap);
+            shader.uploadInt("uLightMap", LIGHT_MAP_TEX_SLOT);
+            shader.uploadVec2("uSceneSize", glm::vec2(sceneWidth, sceneHeight));
+        };
+
+        // Free the GPU objects. Must be called from the context that called start().
+        void stop();
+
+        inline void destroy() {
+            delete[] lights;
+            lights = nullptr;
+            numLights = 0;
+            capacity = 0;
+        };
+    }
+}
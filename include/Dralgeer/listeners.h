@@ -15,6 +15,36 @@ namespace Dralgeer {
         };
     }
 
+    // * ====================
+    // * Input Listener
+    // * ====================
+
+    // Tracks whether any input came in at all so the main loop knows when it can go idle.
+    namespace InputListener {
+        extern bool received; // set by every input callback and cleared by the main loop
+        extern double inputTime; // time the oldest input not handled by the main loop yet came in (0 = none)
+
+        // Called by every input callback.
+        inline static void notify() {
+            received = 1;
+            if (inputTime == 0.0) { inputTime = glfwGetTime(); }
+        };
+
+        // Returns the time the oldest input since the last call came in (0 if there was none).
+        inline static double takeInputTime() {
+            double t = inputTime;
+            inputTime = 0.0;
+            return t;
+        };
+
+        // Returns whether any input was received since the last call.
+        inline static bool consume() {
+            bool r = received;
+            received = 0;
+            return r;
+        };
+    }
+
     // * ====================
     // * Mouse Listener
     // * ====================
@@ -32,6 +62,7 @@ namespace Dralgeer {
         extern float mGameViewPortWidth, mGameViewPortHeight;
 
         static void cursor_position_callback(GLFWwindow* window, double xpos, double ypos) {
+            InputListener::notify();
             if (mButtonsDown) { mIsDragging = 1; }
 
             mLastX = mX;
@@ -41,6 +72,8 @@ namespace Dralgeer {
         };
 
         static void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
+            InputListener::notify();
+
             if (button < 9) {
                 if (action == GLFW_PRESS) {
                     mButtonsDown++;
@@ -55,6 +88,7 @@ namespace Dralgeer {
         };
 
         static void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
+            InputListener::notify();
             mScrollX = xoffset;
             mScrollY = yoffset;
         };
@@ -84,11 +118,20 @@ namespace Dralgeer {
 
     namespace KeyListener {
         extern bool keyPressed[350];
+        extern int keysDown;
 
         static void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+            InputListener::notify();
+
             if (key < 350) {
-                if (action == GLFW_PRESS) { keyPressed[key] = 1; }
-                else if (action == GLFW_RELEASE) { keyPressed[key] = 0; }
+                if (action == GLFW_PRESS) {
+                    if (!keyPressed[key]) { ++keysDown; }
+                    keyPressed[key] = 1;
+
+                } else if (action == GLFW_RELEASE) {
+                    if (keyPressed[key]) { --keysDown; }
+                    keyPressed[key] = 0;
+                }
             }
         };
     }
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "component.h"
+
+namespace Dralgeer {
+    enum MaterialBlend {
+        MATERIAL_BLEND_ALPHA, // drawn over what is behind it
+        MATERIAL_BLEND_ADDITIVE // adds its color to what is behind it (good for glows and spells)
+    };
+
+    // Per sprite looks shared through a table on the GPU.
+    // Each sprite stores the index of its material in its vertices and the shader looks the material up, so changing a material
+    // retints every sprite using it with a single small upload and never touches the batches.
+    // Entry 0 is the default material (no tint or flash) that every sprite starts with.
+    namespace Materials {
+        struct Material {
+            glm::vec4 tint = glm::vec4(1, 1, 1, 1); // multiplied with the sprite's color
+            glm::vec3 flashColor = glm::vec3(1, 1, 1);
+            float flash = 0.0f; // how far the sprite is blended towards the flash color (0 - 1)
+            int paletteRow = -1; // row of the palette the sprite's red channel is looked up in (-1 = no palette swap)
+            MaterialBlend blend = MATERIAL_BLEND_ALPHA;
+        };
+
+        // * Material table (3 texels per material -- tint, flash color and amount, palette row and blend mode).
+        extern Material* materials;
+        extern int numMaterials;
+        extern int capacity;
+
+        extern Texture* palette; // nullptr = palette swaps are ignored
+
+        extern unsigned int tableBuffer, tableTex;
+        extern int bufferCapacity; // materials the buffer has room for
+        extern int dirtyMin, dirtyMax; // range of materials changed since the table was last uploaded (dirtyMin > dirtyMax = none)
+        extern bool started;
+
+        inline void markDirty(int id) {
+            if (id < dirtyMin) { dirtyMin = id; }
+            if (id > dirtyMax) { dirtyMax = id; }
+        };
+
+        // Returns the material's ID.
+        inline int add(Material const &material = Material()) {
+            if (numMaterials == capacity) {
+                capacity = capacity ? 2*capacity : MATERIAL_START_CAPACITY; // destroy() leaves it at 0
+                Material* temp = new Material[capacity];
+                for (int i = 0; i < numMaterials; ++i) { temp[i] = materials[i]; }
+
+                delete[] materials;
+                materials = temp;
+            }
+
+            materials[numMaterials] = material;
+            markDirty(numMaterials);
+            return numMaterials++;
+        };
+
+        inline Material const* get(int id) { return id >= 0 && id < numMaterials ? &materials[id] : nullptr; };
+
+        inline void set(int id, Material const &material) {
+            if (id < 0 || id >= numMaterials) { return; }
+
+            materials[id] = material;
+            markDirty(id);
+        };
+
+        inline void setTint(int id, glm::vec4 const &tint) {
+            if (id < 0 || id >= numMaterials) { return; }
+
+            materials[id].tint = tint;
+            markDirty(id);
+        };
+
+        inline void setFlash(int id, float amount, glm::vec3 const &color = glm::vec3(1, 1, 1)) {
+            if (id < 0 || id >= numMaterials) { return; }
+
+            materials[id].flash = amount;
+            materials[id].flashColor = color;
+            markDirty(id);
+        };
+
+        // Palette swapped sprites look their red channel up in a row of this texture.
+        inline void setPalette(Texture* texture) {
+            palette = texture;
+            markDirty(0); // nothing in the table changes but the scene still has to be redrawn
+        };
+
+        // Point a sprite at a material. Only the sprite itself is rebuffered.
+        inline void use(SpriteRenderer* spr, int id) {
+            if (id < 0 || id >= numMaterials || spr->material == id) { return; }
+
+            spr->material = id;
+            spr->isDirty = 1;
+        };
+
+        inline void start() {
+            glGenBuffers(1, &tableBuffer);
+            GLState::bindBuffer(GL_TEXTURE_BUFFER, tableBuffer);
+            glBufferData(GL_TEXTURE_BUFFER, capacity * MATERIAL_SIZE_BYTES, NULL, GL_DYNAMIC_DRAW);
+            bufferCapacity = capacity;
+
+            glGenTextures(1, &tableTex);
+            GLState::bindTexture(GL_TEXTURE_BUFFER, tableTex);
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, tableBuffer);
+
+            dirtyMin = 0;
+            dirtyMax = numMaterials - 1;
+            started = 1;
+        };
+
+        // Upload the materials that changed. Returns true if anything was uploaded (so the scene looks different).
+        // Call once per frame while nothing is drawing with the table.
+        bool update();
+
+        // Bind the table for a shader that is already in use.
+        inline void bind(Shader const &shader) {
+            GLState::bindTexture(MATERIAL_TABLE_TEX_SLOT, GL_TEXTURE_BUFFER, tableTex);
+            shader.uploadInt("uMaterials", MATERIAL_TABLE_TEX_SLOT);
+            shader.uploadInt("uPaletteRows", palette ? palette->height : 0);
+            if (!palette) { return; }
+
+            GLState::bindTexture(MATERIAL_PALETTE_TEX_SLOT, GL_TEXTURE_2D, palette->texID);
+            shader.uploadInt("uPalette", MATERIAL_PALETTE_TEX_SLOT);
+        };
+
+        inline void destroy() {
+            delete[] materials;
+            materials = nullptr;
+            numMaterials = 0;
+            capacity = 0;
+            palette = nullptr;
+
+            if (started) {
+                glDeleteTextures(1, &tableTex);
+                glDeleteBuffers(1, &tableBuffer);
+
+                GLState::forgetTexture(tableTex);
+                GLState::forgetBuffer(tableBuffer);
+                started = 0;
+            }
+        };
+    }
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "assetpool.h"
+
+namespace Dralgeer {
+    // Emits and simulates particles without any GameObjects or SpriteRenderers.
+    // Particles are stored as a structure of arrays with the live ones packed at the front so they can be integrated 4 at a time with SSE,
+    // and a dead particle is recycled in O(1) by moving the last live one into its slot. Emitters sharing a texture and blend mode have
+    // their arrays packed into one buffer and are drawn with a single instanced draw. Colors and sizes fade over each particle's lifetime
+    // in the vertex shader.
+    class ParticleEmitter {
+        private:
+            unsigned int rng = 0x9E3779B9; // xorshift state
+
+            inline float random(float min, float max) {
+                rng ^= rng << 13;
+                rng ^= rng >> 17;
+                rng ^= rng << 5;
+                return min + (max - min) * (rng * (1.0f/4294967296.0f));
+            };
+
+            float spawnDebt = 0.0f; // fraction of a particle left over from the last update
+
+            void spawn(int count);
+
+        public:
+            // * ==============
+            // * Settings
+            // * ==============
+
+            glm::vec2 pos = glm::vec2(0.0f, 0.0f);
+            float rate = 0.0f; // particles spawned per second
+
+            float direction = 90.0f; // degrees
+            float spread = 360.0f; // degrees around the direction the particles can be shot in
+            float minSpeed = 20.0f, maxSpeed = 60.0f;
+            float minLifetime = 0.5f, maxLifetime = 1.0f;
+            glm::vec2 gravity = glm::vec2(0.0f, 0.0f);
+            float drag = 0.0f; // fraction of the velocity lost per second
+
+            glm::vec4 startColor = glm::vec4(1, 1, 1, 1), endColor = glm::vec4(1, 1, 1, 0);
+            float startSize = 4.0f, endSize = 0.0f;
+            Texture* texture = nullptr; // nullptr = solid squares
+            bool additive = 0; // add the particles' color instead of blending them over the scene (good for fire and spells)
+
+            // * ===================================
+            // * Particles (structure of arrays)
+            // * ===================================
+
+            float* posX = nullptr;
+            float* posY = nullptr;
+            float* velX = nullptr;
+            float* velY = nullptr;
+            float* life = nullptr; // seconds left
+            float* lifetime = nullptr; // seconds the particle started with
+            int numAlive = 0;
+            int capacity = 0;
+
+            inline ParticleEmitter() {};
+
+            // ? Do not allow for reassignment or construction of a ParticleEmitter from another ParticleEmitter
+
+            inline ParticleEmitter(ParticleEmitter const &pe) { throw std::runtime_error("[ERROR] Cannot constructor a ParticleEmitter from another ParticleEmitter."); };
+            inline ParticleEmitter(ParticleEmitter &&pe) { throw std::runtime_error("[ERROR] Cannot constructor a ParticleEmitter from another ParticleEmitter."); };
+            inline ParticleEmitter& operator = (ParticleEmitter const &pe) { throw std::runtime_error("[ERROR] Cannot reassign a ParticleEmitter object. Do NOT use the '=' operator."); };
+            inline ParticleEmitter& operator = (ParticleEmitter &&pe) { throw std::runtime_error("[ERROR] Cannot reassign a ParticleEmitter object. Do NOT use the '=' operator."); };
+
+            // Use Particles::remove to free an emitter that was added.
+            ~ParticleEmitter();
+
+            // * ====================
+            // * Normal Functions
+            // * ====================
+
+            // Allocate room for capacity particles. Once it is full, new particles are dropped until old ones die.
+            void init(int capacity);
+
+            // Spawn count particles right away.
+            inline void burst(int count) { spawn(count); };
+
+            // Spawn, move, and recycle the particles.
+            void update(float dt);
+    };
+
+    // Every emitter that is drawn.
+    namespace Particles {
+        // Every emitter with the same texture and blend mode (their particles are packed into one buffer).
+        struct ParticleDraw {
+            unsigned int vboID; // holds posX, posY, life, lifetime, and each particle's emitter back to back (each is capacity floats long)
+            int numParticles;
+            int capacity;
+            unsigned int texID; // 0 = solid squares
+            bool additive;
+        };
+
+        extern ParticleEmitter** emitters;
+        extern int numEmitters;
+        extern int capacity;
+
+        // * Render thread's GPU objects.
+        extern Shader* shader;
+        extern unsigned int vaoID, quadID;
+        extern bool started;
+
+        // The emitter will be drawn until it is removed.
+        void add(ParticleEmitter* emitter);
+
+        // Stop drawing an emitter and free it.
+        void remove(ParticleEmitter* emitter);
+
+        inline void update(float dt) { for (int i = 0; i < numEmitters; ++i) { emitters[i]->update(dt); }};
+
+        // Pack every emitter's live particles into one buffer per texture and blend mode and upload them along with each emitter's colors
+        // and sizes. Call after the render thread's last frame is finished.
+        void upload();
+
+        // Fill in a draw for every group packed by the last upload. Returns the number of draws.
+        int capture(ParticleDraw* &draws, int &drawCapacity);
+
+        // * Render thread.
+
+        void start(Shader* particleShader); // particle.glsl (must outlive stop())
+        void draw(ParticleDraw const* draws, int numDraws); // the camera UBO must already be set
+        void stop();
+
+        void destroy();
+    }
+}
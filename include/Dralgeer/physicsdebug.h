@@ -0,0 +1,27 @@
+#pragma once
+
+#include <Zeta2D/physicshandler.h>
+#include "debugdraw.h"
+
+namespace Dralgeer {
+    // Overlay for the physics handler.
+    // Everything is emitted as transient DebugDraw lines so the whole overlay is a single upload and draw each frame.
+    namespace PhysicsDebug {
+        extern bool enabled;
+
+        // what to show while the overlay is enabled
+        extern bool showColliders;
+        extern bool showContacts;
+        extern bool showBounds; // the bounding box of each body used by the broad phase
+
+        // Walk the handler's bodies and the last step's contacts.
+        void emit(Zeta::Handler const &handler);
+
+        // Call once per frame after the handler is updated (even on frames it is not).
+        // The handler only keeps its contacts around while the overlay is enabled so this costs nothing when it is not.
+        inline void draw(Zeta::Handler &handler) {
+            handler.recordContacts = enabled && showContacts;
+            if (enabled) { emit(handler); }
+        };
+    }
+}
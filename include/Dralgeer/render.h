@@ -1,5 +1,8 @@
 #pragma once
 
+#include <thread>
+#include <atomic>
+#include <exception>
 #include "component.h"
 
 namespace Dralgeer {
@@ -7,13 +10,38 @@ namespace Dralgeer {
 
     namespace TexSlots { static int texSlots[MAX_TEXTURES] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15}; }
 
+    enum StaticBatchState {
+        STATIC_BATCH_EMPTY,
+        STATIC_BATCH_BUILDING, // the vertices are being made on a worker thread
+        STATIC_BATCH_UPLOADING, // the vertices are being sent to the GPU a chunk per frame
+        STATIC_BATCH_READY
+    };
+
     // A render batch of completely static elements. Once this is initialized, it cannot be changed.
+    // Building one happens in two phases: the vertices and indices are made on the CPU (by any thread) and then uploaded by the thread
+    // that draws it. initAsync() runs the first phase on a worker thread and spreads the second over the next few frames it is drawn
+    // so entering a large room does not hitch.
     class StaticBatch {
         private:
             Texture* textures[MAX_TEXTURES];
             int numTextures = 0;
-            int numSprites;
-            unsigned int vaoID, vboID, eboID;
+            int numSprites = 0;
+            unsigned int vaoID = 0, vboID = 0, eboID = 0;
+
+            // * Build state.
+            StaticBatchState state = STATIC_BATCH_EMPTY; // only used from the drawing thread
+            float* vertices = nullptr; // freed once uploaded
+            unsigned int* indices = nullptr;
+            long long uploaded = 0; // bytes of the vertices (then the indices) sent so far
+            std::thread builder;
+            std::atomic<bool> built{0}; // the worker thread is done
+            std::exception_ptr error; // thrown by the worker thread (rethrown on the drawing thread)
+
+            // Make the vertices and indices. Makes no GL calls.
+            void build(SpriteRenderer* const* spr, int size);
+
+            // Send up to budget bytes (< 0 = no limit) to the GPU. Returns true once the batch can be drawn.
+            bool upload(long long budget);
 
         public:
             inline StaticBatch() {};
@@ -35,98 +63,221 @@ namespace Dralgeer {
             // * Normal Functions
             // * ===================
 
+            // Build and upload the batch right away. Must be called from the thread that draws it.
             void init(SpriteRenderer** spr, int size);
-            void render(Shader const &currShader, Camera const &cam);
+
+            // Build the batch on a worker thread. It is uploaded over the next frames it is drawn and draws nothing until then.
+            // * The sprites must stay alive and unchanged until isReady() (the array of them does not).
+            void initAsync(SpriteRenderer** spr, int size);
+
+            inline bool isReady() const { return state == STATIC_BATCH_READY; };
+
+            void render(Shader const &currShader);
+    };
+
+    // * ===============================================
+    // * Batch Policies
+
+    enum BatchUpload {
+        BATCH_UPLOAD_ALL, // rewrite every sprite's vertices when any of them change
+        BATCH_UPLOAD_DIRTY_RANGE // only rewrite the sprites from the first dirty one to the last dirty one
     };
 
-    // A batch of purely dynamic sprites. These sprites will be updated (freqently).
-    class DynamicBatch { // todo add add sprites method here, too
+    // Vertex format used by every sprite batch.
+    struct SpriteVertex {
+        static constexpr int size = VERTEX_SIZE; // floats per vertex
+
+        // Make a VAO reading the vertices from vbo and the indices from ebo.
+        static unsigned int createVertexArray(unsigned int vbo, unsigned int ebo);
+
+        // Fill in the 4 vertices of a sprite.
+        static void load(float* vertices, SpriteRenderer const* spr, int texID);
+    };
+
+    // ? A batch's traits pick its behavior at compile time:
+    // ?  capacity = max sprites in the batch
+    // ?  Vertex = vertex format (see SpriteVertex)
+    // ?  upload = how changed sprites are sent to the GPU (see BatchUpload)
+    // ?  ownsSprites = whether the batch deletes the sprites it still holds when it is destroyed
+
+    struct DynamicBatchTraits {
+        static constexpr int capacity = MAX_DYNAMIC_BATCH_SIZE;
+        typedef SpriteVertex Vertex;
+        static constexpr BatchUpload upload = BATCH_UPLOAD_ALL; // small enough that tracking the range is not worth it
+        static constexpr bool ownsSprites = 0; // the SubScene deletes its sprites
+    };
+
+    struct EditorBatchTraits {
+        static constexpr int capacity = MAX_RENDER_BATCH_SIZE;
+        typedef SpriteVertex Vertex;
+        static constexpr BatchUpload upload = BATCH_UPLOAD_DIRTY_RANGE;
+        static constexpr bool ownsSprites = 0; // the render thread deletes its copies of the sprites
+    };
+
+    // A batch of sprites that can be updated (frequently).
+    // Sprites are kept grouped by the texture slot they use (untextured sprites go last) and a slot is freed once its last sprite
+    // is removed. Adding or removing a sprite only moves one sprite per group after it, so the grouping is kept up to date cheaply.
+    // A y-sorted batch instead keeps its sprites ordered by their foot (bottom) y so the sprite closest to the viewer is drawn first
+    // (and wins the depth test like a higher zIndex would). It is re-sorted every frame with an insertion sort since the order barely
+    // changes between frames, and only the sprites that moved in the order are rewritten.
+    // The member functions are defined in render.cpp and only instantiated for the traits declared above,
+    // so add an explicit instantiation there when adding new traits.
+    template <typename Traits>
+    class Batch {
         private:
-            SpriteRenderer* sprites[MAX_DYNAMIC_BATCH_SIZE];
-            float vertices[MAX_DYNAMIC_VERTICES_SIZE] = {0};
-            Texture* textures[MAX_TEXTURES];
+            static constexpr int SPRITE_FLOATS = 4 * Traits::Vertex::size;
+            static constexpr int NUM_GROUPS = MAX_TEXTURES + 1; // one per texture slot + untextured sprites
+
+            SpriteRenderer* sprites[Traits::capacity];
+            float vertices[Traits::capacity * SPRITE_FLOATS] = {0};
+            Texture* textures[MAX_TEXTURES] = {nullptr}; // nullptr = free slot
+            int groupEnd[NUM_GROUPS] = {0}; // index after the last sprite of each group
             unsigned int vaoID, vboID, eboID;
+            bool started = 0;
+
+            // * Only used while y-sorted.
+            bool ySort = 0;
+            float* keys = nullptr; // foot y of each sprite
+            unsigned char* slots = nullptr; // texture slot of each sprite (MAX_TEXTURES = untextured)
+
+            void sortByY();
+
+            // Move a sprite to an empty spot.
+            inline void move(int from, int to) {
+                sprites[to] = sprites[from];
+                sprites[to]->isDirty = 1;
+            };
 
-            // * Helper to just make the code easier to read and debug.
-            // * Will probs be moved directly into the code in the end.
-            void loadVertexProperties(int index);
-        
         public:
+            Batch<Traits>* next = nullptr; // batch the rest of the layer spills into (deleted with this one)
             int numSprites = 0;
-            int numTextures = 0;
+            int numTextures = 0; // texture slots in use
 
-            inline DynamicBatch() {};
+            inline Batch() {};
 
             // * ===================
             // * Rule of 5 Stuff
             // * ===================
 
             // ? These are all designed to throw errors with the exception of the destructor.
-            // ? DynamicBatches should NOT be reassigned or constructed from another.
+            // ? Batches should NOT be reassigned or constructed from another.
 
-            DynamicBatch(DynamicBatch const &batch);
-            DynamicBatch(DynamicBatch &&batch);
-            DynamicBatch& operator = (DynamicBatch const &batch);
-            DynamicBatch& operator = (DynamicBatch &&batch);
-            ~DynamicBatch();
+            inline Batch(Batch const &batch) { throw std::runtime_error("[ERROR] Cannot constructor a Batch from another Batch."); };
+            inline Batch(Batch &&batch) { throw std::runtime_error("[ERROR] Cannot constructor a Batch from another Batch."); };
+            inline Batch& operator = (Batch const &batch) { throw std::runtime_error("[ERROR] Cannot reassign a Batch object. Do NOT use the '=' operator."); };
+            inline Batch& operator = (Batch &&batch) { throw std::runtime_error("[ERROR] Cannot reassign a Batch object. Do NOT use the '=' operator."); };
+            ~Batch();
 
             // * ===================
             // * Normal Functions
             // * ===================
 
+            // Create the GPU objects. Does nothing if the batch was already started.
             void start();
-            void render(Shader const &currShader, Camera const &cam);
+            void render(Shader const &currShader);
 
             // * Returns true if the SpriteRenderer is successfully removed and false if it doesn't exist.
             bool destroyIfExists(SpriteRenderer* spr);
-            void addSprite(SpriteRenderer* spr);
-            // void addSprites(SpriteRenderer** spr, int size);
+
+            // * Returns false if the batch is full or has no free slot for the sprite's texture.
+            bool addSprite(SpriteRenderer* spr);
+
             bool hasTexture(Texture* tex) const;
+
+            inline bool isFull() const { return numSprites >= Traits::capacity; };
+
+            // Is there room for a sprite with this texture?
+            inline bool canAdd(Texture* tex) const { return !isFull() && (!tex || numTextures < MAX_TEXTURES || hasTexture(tex)); };
+
+            // Switch between grouping the sprites by texture and keeping them sorted by y.
+            void setYSort(bool ySort);
+            inline bool isYSorted() const { return ySort; };
     };
 
-    class EditorBatch { // todo add an addSprites method
+    typedef Batch<DynamicBatchTraits> DynamicBatch;
+    typedef Batch<EditorBatchTraits> EditorBatch;
+
+    extern template class Batch<DynamicBatchTraits>;
+    extern template class Batch<EditorBatchTraits>;
+
+    // How a layer scrolls with the camera.
+    // The layer is offset in the vertex shader so its sprites' vertices never change no matter how far the camera moves.
+    struct Parallax {
+        glm::vec2 factor = glm::vec2(1, 1); // fraction of the camera's movement the layer follows (1 = moves with the world, 0 = fixed to the view)
+        glm::vec2 repeat = glm::vec2(0, 0); // world units after which the layer repeats along each axis (0 = never)
+
+        inline bool isDefault() const { return factor.x == 1.0f && factor.y == 1.0f && repeat.x <= 0.0f && repeat.y <= 0.0f; };
+    };
+
+    // Batches of sprites sorted by zIndex.
+    // Each zIndex has a batch and spills into more batches once it runs out of room or texture slots. A sprite goes into the
+    // layer's batch that already has its texture whenever possible so each batch touches as few textures as it can.
+    // Layers can be y-sorted instead (see Batch). Batches of a layer are drawn one after the other so only the sprites within a batch
+    // are sorted with each other, meaning a y-sorted layer should fit in one batch.
+    // Layers can also scroll at their own rate (see Parallax). A repeating layer is drawn once more along each axis it repeats on, so
+    // its content should be at least as large as the view along that axis.
+    template <typename Traits>
+    class LayeredBatches {
         private:
-            SpriteRenderer* sprites[MAX_RENDER_BATCH_SIZE];
-            float vertices[MAX_RENDER_VERTICES_LIST_SIZE] = {0};
-            Texture* textures[MAX_TEXTURES];
-            unsigned int vaoID, vboID, eboID;
+            Batch<Traits> batches[MAX_RENDER_BATCHES]; // Note: zIndices from -499 to 500 are permitted
+            int layerSizes[MAX_RENDER_BATCHES] = {0}; // sprites in each layer (across all of its batches)
+            bool ySorted[MAX_RENDER_BATCHES] = {0};
+            Parallax parallax[MAX_RENDER_BATCHES];
+            int indices[MAX_RENDER_BATCHES]; // layers that contain sprites
+            int numIndices = 0; // the number of layers that cointain sprites
+
+            // Helper function to add a layer.
+            void addBatch(int n);
+
+            // Add a sprite to the best batch of a layer.
+            void addToLayer(int n, SpriteRenderer* spr);
 
-            // * Helper to just make the code easier to read and debug.
-            // * Will probs be moved directly into the code in the end.
-            void loadVertexProperties(int index);
-            
         public:
-            int numSprites = 0;
-            int numTextures = 0;
+            inline LayeredBatches() {};
 
-            inline EditorBatch() {};
+            // ? Do not allow for reassignment or construction of a LayeredBatches from another LayeredBatches
 
-            // * ===================
-            // * Rule of 5 Stuff
-            // * ===================
+            inline LayeredBatches(LayeredBatches const &lb) { throw std::runtime_error("[ERROR] Cannot constructor a LayeredBatches from another LayeredBatches."); };
+            inline LayeredBatches(LayeredBatches &&lb) { throw std::runtime_error("[ERROR] Cannot constructor a LayeredBatches from another LayeredBatches."); };
+            inline LayeredBatches& operator = (LayeredBatches const &lb) { throw std::runtime_error("[ERROR] Cannot reassign a LayeredBatches object. Do NOT use the '=' operator."); };
+            inline LayeredBatches& operator = (LayeredBatches &&lb) { throw std::runtime_error("[ERROR] Cannot reassign a LayeredBatches object. Do NOT use the '=' operator."); };
 
-            // ? These are all designed to throw errors with the exception of the destructor.
-            // ? EditorBatches should NOT be reassigned or constructed from another.
+            // * ====================
+            // * Normal Functions
+            // * ====================
 
-            EditorBatch(EditorBatch const &batch);
-            EditorBatch(EditorBatch &&batch);
-            EditorBatch& operator = (EditorBatch const &batch);
-            EditorBatch& operator = (EditorBatch &&batch);
-            ~EditorBatch();
+            void add(SpriteRenderer* spr);
 
-            // * ===================
-            // * Normal Functions
-            // * ===================
+            // remove a sprite renderer contained in the renderer
+            // returns 1 if it successfully found and destroyed it and 0 otherwise
+            bool destroy(SpriteRenderer* spr);
 
-            void start();
-            void render(Shader const &currShader, Camera const &cam);
+            // render each batch
+            // * The camera is read from the camera UBO so GLState::setCamera must be called first.
+            void render(Shader const &currShader);
 
-            // * Returns true if the SpriteRenderer is successfully removed and false if it doesn't exist.
-            bool destroyIfExists(SpriteRenderer* spr);
-            void addSprite(SpriteRenderer* spr);
-            bool hasTexture(Texture* tex) const;
+            // update the list of zIndices when called
+            // spr = the SpriteRenderer whose zIndex was changed
+            inline void updateZIndex(SpriteRenderer* spr) { if (destroy(spr)) { add(spr); }};
+
+            // regroup a sprite whose texture was changed
+            inline void updateTexture(SpriteRenderer* spr) { if (destroy(spr)) { add(spr); }};
+
+            // Draw a layer's sprites in y order (or go back to grouping them by texture).
+            void setYSort(int zIndex, bool ySort);
+            inline bool isYSorted(int zIndex) const { return zIndex >= -499 && zIndex <= 500 && ySorted[zIndex + 499]; };
+
+            inline void setParallax(int zIndex, Parallax const &p) { if (zIndex >= -499 && zIndex <= 500) { parallax[zIndex + 499] = p; }};
+            // layers out of range scroll with the world
+            inline Parallax const& getParallax(int zIndex) const {
+                static Parallax const none;
+                return zIndex >= -499 && zIndex <= 500 ? parallax[zIndex + 499] : none;
+            };
     };
 
+    extern template class LayeredBatches<DynamicBatchTraits>;
+    extern template class LayeredBatches<EditorBatchTraits>;
+
     // todo update the constant for the max number of batches
     // todo  probs make it 1000 and limit z-index accordingly
     // todo  otherwise it will eat up too much RAM
@@ -139,11 +290,7 @@ namespace Dralgeer {
     class Renderer {
         private:
             StaticBatch staticBatch; // static batch for each of the static objects in a subscene
-            DynamicBatch batches[MAX_RENDER_BATCHES]; // Note: zIndices from -499 to 500 are permitted
-            int indices[MAX_RENDER_BATCHES]; // batches that contain sprites
-            int numIndices = 0; // the number of dynamic batches that cointain sprites
-
-            void addBatch(int n);
+            LayeredBatches<DynamicBatchTraits> batches;
 
         public:
             inline Renderer() {};
@@ -160,90 +307,33 @@ namespace Dralgeer {
             // * Normal Functions
             // * ====================
 
-            inline void init(SpriteRenderer** spr, int size) { staticBatch.init(spr, size); };
-            void add(SpriteRenderer* spr);
-            bool destroy(SpriteRenderer* spr);
+            // The static sprites are built into a batch off of the main thread (see StaticBatch::initAsync).
+            inline void init(SpriteRenderer** spr, int size) { staticBatch.initAsync(spr, size); };
+            inline bool isReady() const { return staticBatch.isReady(); };
+            inline void add(SpriteRenderer* spr) { batches.add(spr); };
+            inline bool destroy(SpriteRenderer* spr) { return batches.destroy(spr); };
             
             // todo could also rely on making a separate shader for the static sprites which displays them at like z = -1 instead of z = 0
-            inline void render(Shader const &currShader, Camera const &cam) { // todo make sure they're renderered in the right order
-                staticBatch.render(currShader, cam);
-                for (int i = 0; i < numIndices; ++i) { batches[indices[i]].render(currShader, cam); }
+            // * The camera is read from the camera UBO so GLState::setCamera must be called first.
+            inline void render(Shader const &currShader) { // todo make sure they're renderered in the right order
+                staticBatch.render(currShader);
+                batches.render(currShader);
             };
 
             // update the list of zIndices when called
             // spr = the SpriteRenderer whose zIndex was changed
-            void updateZIndex(SpriteRenderer* spr);
-    };
+            inline void updateZIndex(SpriteRenderer* spr) { batches.updateZIndex(spr); };
 
-    // Renderer specific to the level editor.
-    class EditorRenderer {
-        private:
-            EditorBatch batches[MAX_RENDER_BATCHES]; // Note: zIndices from -499 to 500 are permitted
-            int indices[MAX_RENDER_BATCHES]; // batches that contain sprites
-            int numIndices = 0; // the number of batches that cointain sprites
-
-            // Helper function to add a dynamic batch.
-            void addBatch(int n);
-
-        public:
-            inline EditorRenderer() {};
-
-            // ? Do not allow for reassignment or construction of an EditorRenderer from another EditorRenderer
+            // regroup a sprite whose texture was changed
+            inline void updateTexture(SpriteRenderer* spr) { batches.updateTexture(spr); };
 
-            inline EditorRenderer(EditorRenderer const &renderer) { throw std::runtime_error("[ERROR] Cannot constructor a EditorRenderer from another EditorRenderer."); };
-            inline EditorRenderer(EditorRenderer &&renderer) { throw std::runtime_error("[ERROR] Cannot constructor a EditorRenderer from another EditorRenderer."); };
-            inline EditorRenderer& operator = (EditorRenderer const &batch) { throw std::runtime_error("[ERROR] Cannot reassign a EditorRenderer object. Do NOT use the '=' operator."); };
-            inline EditorRenderer& operator = (EditorRenderer &&batch) { throw std::runtime_error("[ERROR] Cannot reassign a EditorRenderer object. Do NOT use the '=' operator."); };
+            // Draw a layer's sprites in y order (or go back to grouping them by texture).
+            inline void setYSort(int zIndex, bool ySort) { batches.setYSort(zIndex, ySort); };
 
-            inline void add(SpriteRenderer* spr) {
-                if (!spr || spr->transform.zIndex < -499 || spr->transform.zIndex > 500) { return; } // todo use an appropriate logger message when I fix that
-
-                int n = spr->transform.zIndex + 499;
-                if (batches[n].numSprites >= MAX_RENDER_BATCH_SIZE) { return; } // todo use an info message here
-
-                if (numIndices == 0) {
-                    indices[numIndices++] = n;
-                    batches[n].start();
-                    batches[n].addSprite(spr);
-                    return;
-                }
-
-                if (batches[n].numSprites == 0) { addBatch(n); }
-                batches[n].addSprite(spr);
-            };
-
-            // remove a sprite renderer contained in the renderer
-            // returns 1 if it successfully found and destroyed it and 0 otherwise
-            inline bool destroy(SpriteRenderer* spr) {
-                for (int i = 0; i < numIndices; ++i) {
-                    if (batches[indices[i]].destroyIfExists(spr)) {
-                        if (batches[indices[i]].numSprites == 0) {
-                            for (int j = i; j < numIndices - 1; ++j) { indices[j] = indices[j + 1]; }
-                            --numIndices;
-                        }
-
-                        return 1;
-                    }
-                }
-
-                return 0;
-            };
-
-            // render each batch
-            inline void render(Shader const &currShader, Camera const &cam) {
-                for (int i = 0; i < numIndices; ++i) { batches[indices[i]].render(currShader, cam); }
-                // gizmoBatch.render(cam);
-            };
-
-            // update the list of zIndices when called
-            // spr = the SpriteRenderer whose zIndex was changed
-            inline void updateZIndex(SpriteRenderer* spr) {
-                if (!destroy(spr)) { return; }
-
-                // add the sprite to the new batch it belongs to
-                int n = spr->transform.zIndex + 499;
-                if (batches[n].numSprites == 0) { addBatch(n); }
-                batches[n].addSprite(spr);
-            };
+            // Scroll a layer at its own rate.
+            inline void setParallax(int zIndex, Parallax const &p) { batches.setParallax(zIndex, p); };
     };
+
+    // Renderer specific to the level editor.
+    typedef LayeredBatches<EditorBatchTraits> EditorRenderer;
 }
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cmath>
+#include "constants.h"
+
+namespace Dralgeer {
+    // Dynamic resolution for the scene.
+    // The scene is rendered at scale times the size of the game viewport and scaled back up with nearest filtering. While enabled, the
+    // scale follows the GPU time of the scene so the frame rate holds when the scene gets heavy.
+    namespace RenderScale {
+        extern bool enabled; // let the controller pick the scale (otherwise it is left wherever it was set)
+        extern float scale;
+        extern float gpuTime; // smoothed GPU time of the scene in ms
+        extern int cooldown; // frames until the scale can be adjusted again
+
+        // Feed in the GPU time (ms) of the last frame drawn. Call once per frame.
+        inline void update(float frameTime) {
+            if (frameTime <= 0.0f) { return; } // no new measurement
+
+            gpuTime = gpuTime > 0.0f ? gpuTime + RENDER_TIME_SMOOTHING*(frameTime - gpuTime) : frameTime;
+            if (!enabled) { return; }
+
+            if (cooldown > 0) { --cooldown; return; }
+
+            float load = gpuTime/RENDER_TARGET_GPU_TIME;
+            if (load >= RENDER_LOAD_LOW && load <= RENDER_LOAD_HIGH) { return; }
+
+            // the cost of a frame is mostly the pixels shaded, which goes with the square of the scale
+            float next = scale * std::sqrt(RENDER_LOAD_AIM/load);
+
+            if (next > scale + RENDER_SCALE_MAX_STEP) { next = scale + RENDER_SCALE_MAX_STEP; }
+            else if (next < scale - RENDER_SCALE_MAX_STEP) { next = scale - RENDER_SCALE_MAX_STEP; }
+
+            if (next > RENDER_SCALE_MAX) { next = RENDER_SCALE_MAX; }
+            else if (next < RENDER_SCALE_MIN) { next = RENDER_SCALE_MIN; }
+
+            if (next == scale) { return; }
+
+            scale = next;
+            cooldown = RENDER_SCALE_COOLDOWN; // give the smoothed time a chance to catch up to the new scale
+        };
+
+        // Size to render something of the given size at.
+        inline int apply(float size) {
+            int scaled = (int) (size*scale + 0.5f);
+            return scaled < 1 ? 1 : scaled;
+        };
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <GL/glew.h>
+#include "constants.h"
+
+namespace Dralgeer {
+    // Counters for what the renderer does each frame and how much GPU memory its resources take up.
+    // The draws are counted by the render thread as it submits them. Uploads are counted from both threads (the main thread fills the
+    // shared tables between frames) and land in the next frame the render thread finishes.
+    // VRAM is tracked by the GPU layer for every buffer, texture, and renderbuffer made through it. The sizes are what was asked for,
+    // so padding and whatever the driver keeps on the side are not included.
+    namespace RenderStats {
+        enum VramCategory {
+            VRAM_BUFFERS, // vertex, index, and table buffers
+            VRAM_TEXTURES, // sprites, fonts, palettes, and lookup textures
+            VRAM_TARGETS, // textures and renderbuffers drawn to (framebuffers, the picking texture, and the frame graph's targets)
+            NUM_VRAM_CATEGORIES
+        };
+
+        struct LayerStats {
+            int zIndex;
+            int batches;
+            int sprites;
+        };
+
+        struct FrameStats {
+            int drawCalls = 0; // every draw the render thread made (batches, lighting, particles, lines, and the grid)
+            int batchDraws = 0; // sprite batch draws (a batch is drawn once per pass and per repeat of its layer)
+            int spritesDrawn = 0;
+            long long bytesUploaded = 0; // buffer and texture data sent to the GPU
+            int textureBinds = 0; // binds that were not skipped by the state cache
+            float gpuTime = 0.0f; // ms (0 = nothing new was measured)
+
+            LayerStats layers[RENDER_STATS_MAX_LAYERS]; // sprite layers in draw order (each is listed once even if drawn by several passes)
+            int numLayers = 0;
+        };
+
+        // Point on the stats panel's graphs.
+        struct FrameSample {
+            float drawCalls;
+            float uploadKB;
+            float gpuTime; // ms (the last measurement carries over until a new one comes in)
+        };
+
+        // * Render thread.
+        extern FrameStats current; // frame being drawn
+
+        // * Both threads.
+        extern std::atomic<long long> uploadBytes; // uploaded since the render thread last finished a frame
+
+        inline void countDraw() { ++current.drawCalls; };
+
+        inline void countBatch(int sprites) {
+            ++current.drawCalls;
+            ++current.batchDraws;
+            current.spritesDrawn += sprites;
+        };
+
+        // Record a layer's batches. Only the first pass to draw a layer each frame lists it.
+        void countLayer(int zIndex, int batches, int sprites);
+
+        inline void uploaded(long long bytes) { if (bytes > 0) { uploadBytes.fetch_add(bytes, std::memory_order_relaxed); }};
+
+        // Finish the frame the render thread drew and start the next one.
+        // Returns the finished frame (valid until the next call).
+        FrameStats const& endFrame(int textureBinds, float gpuTime);
+
+        // * ===================
+        // * VRAM
+        // * ===================
+
+        // ? Buffers, textures, and renderbuffers are shared by every context so their names are unique per kind.
+
+        // Bytes per pixel of data sent in a format.
+        inline int pixelBytes(GLenum format, GLenum type) {
+            int components = format == GL_RED ? 1 : format == GL_RG ? 2 : format == GL_RGB ? 3 : 4;
+            return type == GL_FLOAT ? 4*components : components;
+        };
+
+        // Bytes a 2D texture of the format takes up (levels includes the base level).
+        long long textureBytes(GLenum internalFormat, int width, int height, int levels);
+
+        void setBufferSize(unsigned int id, long long bytes);
+        void setTextureSize(unsigned int id, long long bytes);
+        void setRenderbufferSize(unsigned int id, long long bytes);
+
+        // Count a texture as a render target from now on (called when it is attached to a framebuffer).
+        void markTarget(unsigned int texID);
+
+        void freeBuffer(unsigned int id);
+        void freeTexture(unsigned int id);
+        void freeRenderbuffer(unsigned int id);
+
+        // Bytes currently held by a category.
+        long long vram(VramCategory category);
+    }
+}
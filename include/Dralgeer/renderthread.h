@@ -0,0 +1,344 @@
+#pragma once
+
+#include <thread>
+#include <cstring>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include "render.h"
+#include "framebuffer.h"
+#include "debugdraw.h"
+#include "animation.h"
+#include "lighting.h"
+#include "particles.h"
+#include "framegraph.h"
+#include "discovery.h"
+#include "renderstats.h"
+
+namespace Dralgeer {
+    enum SpriteCommandType {
+        SPRITE_ADD,
+        SPRITE_UPDATE, // also handles zIndex changes
+        SPRITE_REMOVE
+    };
+
+    struct SpriteCommand {
+        SpriteCommandType type;
+        SpriteRenderer* key; // the simulation's sprite (only used to find the render thread's copy of it)
+        SpriteRenderer state; // the sprite's state when the command was recorded
+    };
+
+    // Everything the render thread needs to draw a frame.
+    // Only the sprites that changed are included. The render thread keeps its own copy of every other sprite.
+    class RenderSnapshot {
+        public:
+            SpriteCommand* commands = nullptr;
+            int numCommands = 0;
+            int capacity = 0;
+
+            Camera camera;
+            float time = 0.0f; // animation time for the frame
+            bool renderGrid = 0;
+            bool clear = 0; // throw out every sprite before applying the commands (used when the scene changes)
+            bool animating = 0; // a sprite is playing an animation (so the frame changes with time alone)
+
+            // * Scene framebuffer.
+            int sceneWidth = 1, sceneHeight = 1; // region to render to
+            int targetWidth = 1, targetHeight = 1; // size of the framebuffer's texture (its attachments are remade when this changes)
+
+            // * What is read from the frame once it is drawn (passes nothing reads are culled).
+            bool sceneVisible = 1; // the Game Viewport shows the scene
+            bool picking = 0; // the picking texture might be read
+
+            // * Debug lines (laid out like the DebugDraw stores).
+            float* persistentLines = nullptr;
+            int numPersistent = 0;
+            int persistentCapacity = 0;
+            bool rebufferLines = 0;
+
+            float* transientLines = nullptr;
+            int numTransient = 0;
+            int transientCapacity = 0;
+
+            // * Lights.
+            Lighting::PointLight* lights = nullptr;
+            int numLights = 0;
+            int lightCapacity = 0;
+            glm::vec3 ambient;
+            bool lighting = 0; // draw the light map for the frame
+            bool lightsChanged = 0;
+
+            // * Layer modes (only filled in when they change).
+            bool ySortLayers[MAX_RENDER_BATCHES]; // indexed by zIndex + 499
+            Parallax parallaxLayers[MAX_RENDER_BATCHES];
+            bool layersChanged = 0;
+
+            // * Fog of war.
+            bool fog = 0;
+            glm::vec2 fogOrigin, fogSize; // world region the active map covers
+            glm::vec3 fogColor;
+            bool fogChanged = 0;
+
+            // * Particles.
+            Particles::ParticleDraw* particleDraws = nullptr;
+            int numParticleDraws = 0;
+            int particleDrawCapacity = 0;
+
+            inline RenderSnapshot() {};
+
+            // * ===================
+            // * Rule of 5 Stuff
+            // * ===================
+
+            // ? These are all designed to throw errors with the exception of the destructor.
+            // ? RenderSnapshots should NOT be reassigned or constructed from another.
+
+            inline RenderSnapshot(RenderSnapshot const &snap) { throw std::runtime_error("[ERROR] Cannot constructor a RenderSnapshot from another RenderSnapshot."); };
+            inline RenderSnapshot(RenderSnapshot &&snap) { throw std::runtime_error("[ERROR] Cannot constructor a RenderSnapshot from another RenderSnapshot."); };
+            inline RenderSnapshot& operator = (RenderSnapshot const &snap) { throw std::runtime_error("[ERROR] Cannot reassign a RenderSnapshot object. Do NOT use the '=' operator."); };
+            inline RenderSnapshot& operator = (RenderSnapshot &&snap) { throw std::runtime_error("[ERROR] Cannot reassign a RenderSnapshot object. Do NOT use the '=' operator."); };
+
+            inline ~RenderSnapshot() {
+                delete[] commands;
+                delete[] persistentLines;
+                delete[] transientLines;
+                delete[] lights;
+                delete[] particleDraws;
+            };
+
+            // * ====================
+            // * Normal Functions
+            // * ====================
+
+            // Get ready to record the next frame. Keeps the memory around.
+            inline void reset() {
+                numCommands = 0;
+                numTransient = 0;
+                rebufferLines = 0;
+                clear = 0;
+                layersChanged = 0;
+            };
+
+            // Does the snapshot change anything about the scene besides the camera and the framebuffer?
+            inline bool hasWork() const { return numCommands || clear || animating || rebufferLines || numTransient || lightsChanged || numParticleDraws || layersChanged ||
+                    fogChanged; };
+
+            // Record a change to a sprite. The sprite is no longer dirty as far as the simulation is concerned.
+            void record(SpriteCommandType type, SpriteRenderer* spr);
+
+            // Copy the DebugDraw stores into the snapshot and throw out the transient lines.
+            void captureDebugLines();
+
+            // Copy the lights into the snapshot.
+            void captureLights();
+
+            // Copy how the fog is drawn into the snapshot. Discovery::upload() must be called before submitting.
+            inline void captureDiscovery() {
+                DiscoveryMap const* map = Discovery::active;
+
+                fog = Discovery::enabled && map;
+                if (map) {
+                    fogOrigin = map->origin;
+                    fogSize = glm::vec2(map->width * map->cellSize, map->height * map->cellSize);
+                }
+
+                fogColor = Discovery::fogColor;
+                fogChanged = Discovery::changed;
+                Discovery::changed = 0;
+            };
+
+            // Record a draw for every group of emitters packed by Particles::upload() (which must be called before this).
+            inline void captureParticles() { numParticleDraws = Particles::capture(particleDraws, particleDrawCapacity); };
+    };
+
+    // Thread that owns all of the scene's GL submission.
+    // It runs on its own context shared with the main window's so the framebuffer, picking texture, textures, shaders, and buffers are
+    // shared while the VAOs and FBOs it draws with are its own.
+    // The simulation fills one snapshot while the render thread draws the other. Only one frame can be in flight so the displayed
+    // frame is never more than a frame behind the simulation.
+    class RenderThread {
+        private:
+            GLFWwindow* context = nullptr; // hidden window holding the render thread's context
+            std::thread thread;
+            std::mutex mutex;
+            std::condition_variable cv;
+
+            RenderSnapshot snapshots[2];
+            int front = 0; // snapshot owned by the render thread (the other one is being recorded)
+            bool pending = 0; // a snapshot has been submitted and not drawn yet
+            bool running = 0;
+            GLsync submitFence = 0; // signaled once the main context's work for the submitted frame is done
+            GLsync doneFence = 0; // signaled once the render thread's work for the submitted frame is done
+            GLState::Counters stats; // bind counters for the last frame drawn
+            GLDebug::CallCounts calls; // GL calls of the last frame drawn (debug builds only)
+            float gpuTime = 0.0f; // GPU time in ms of the latest frame measured (0 if nothing new was measured)
+            PassTiming passTimings[FRAME_GRAPH_MAX_PASSES]; // passes of the last frame drawn
+            int numPassTimings = 0;
+            RenderStats::FrameStats frameStats; // counters of the last frame drawn
+            RenderStats::FrameSample history[RENDER_STATS_HISTORY] = {}; // ring of the latest frames drawn
+            int historyIndex = 0; // oldest sample (the next one to be overwritten)
+
+            // * Only used from the render thread.
+            EditorRenderer* renderer = nullptr;
+            std::unordered_map<SpriteRenderer*, SpriteRenderer*> proxies; // simulation's sprite -> render thread's copy
+            GridLines* gridLines = nullptr;
+            FrameGraph graph;
+            unsigned int sceneFBO, pickingFBO;
+            unsigned int sceneTexID, sceneRboID, pickingTexID, pickingDepthID;
+            int targetWidth = 0, targetHeight = 0; // size of the scene framebuffer the last time it was attached
+            bool sceneComplete = 1, pickingComplete = 1; // an incomplete framebuffer's passes are culled instead of drawn
+
+            bool ySortLayers[MAX_RENDER_BATCHES] = {0}; // layer modes (only used from the main thread)
+            Parallax parallaxLayers[MAX_RENDER_BATCHES];
+
+            // * Last submitted view (only used from the main thread).
+            Camera lastCamera;
+            int lastWidth = 0, lastHeight = 0;
+            bool lastVisible = 1, lastPicking = 0;
+
+            // * Shaders (owned by the render thread).
+            Shader* defaultShader = nullptr;
+            Shader* pickingShader = nullptr;
+            Shader* lineShader = nullptr;
+            Shader* gridShader = nullptr;
+            Shader* lightingShader = nullptr;
+            Shader* particleShader = nullptr;
+
+            inline static Shader* loadShader(std::string const &filepath) {
+                Shader* shader = new Shader();
+                shader->readSource(filepath);
+                shader->compile();
+                return shader;
+            };
+
+            void loop();
+            void apply(RenderSnapshot &snap);
+            void draw(RenderSnapshot &snap);
+            void clearSprites();
+            bool attachScene(); // returns whether the framebuffer is complete
+
+            // Send every layer's mode with the frame being recorded.
+            inline void recordLayers() {
+                RenderSnapshot &snap = snapshots[1 - front];
+                std::memcpy(snap.ySortLayers, ySortLayers, sizeof(ySortLayers));
+                std::memcpy(snap.parallaxLayers, parallaxLayers, sizeof(parallaxLayers));
+                snap.layersChanged = 1;
+            };
+
+        public:
+            inline RenderThread() {};
+
+            // ? Do not allow for reassignment or construction of a RenderThread from another RenderThread
+
+            inline RenderThread(RenderThread const &rt) { throw std::runtime_error("[ERROR] Cannot constructor a RenderThread from another RenderThread."); };
+            inline RenderThread(RenderThread &&rt) { throw std::runtime_error("[ERROR] Cannot constructor a RenderThread from another RenderThread."); };
+            inline RenderThread& operator = (RenderThread const &rt) { throw std::runtime_error("[ERROR] Cannot reassign a RenderThread object. Do NOT use the '=' operator."); };
+            inline RenderThread& operator = (RenderThread &&rt) { throw std::runtime_error("[ERROR] Cannot reassign a RenderThread object. Do NOT use the '=' operator."); };
+
+
+            // * ====================
+            // * Normal Functions
+            // * ====================
+
+            // Create the render thread's context and start the thread.
+            // Call from the main thread with the window's context current.
+            void init(GLFWwindow* window, FrameBuffer const &frameBuffer, PickingTexture const &pickingTexture);
+
+            // Snapshot currently being recorded by the simulation.
+            inline RenderSnapshot* back() { return &snapshots[1 - front]; };
+
+            inline void record(SpriteCommandType type, SpriteRenderer* spr) { snapshots[1 - front].record(type, spr); };
+
+            // Throw out every sprite the render thread has (along with anything recorded so far this frame).
+            inline void clear() {
+                RenderSnapshot &snap = snapshots[1 - front];
+                snap.numCommands = 0;
+                snap.clear = 1;
+            };
+
+            // Draw a layer's sprites in y order (or go back to grouping them by texture).
+            inline void setYSort(int zIndex, bool ySort) {
+                if (zIndex < -499 || zIndex > 500 || ySortLayers[zIndex + 499] == ySort) { return; }
+                ySortLayers[zIndex + 499] = ySort;
+                recordLayers();
+            };
+
+            inline bool isYSorted(int zIndex) const { return zIndex >= -499 && zIndex <= 500 && ySortLayers[zIndex + 499]; };
+
+            // Scroll a layer at its own rate (e.g. a background following the camera at half speed).
+            // Only the layer's offset in the shader changes as the camera moves so its sprites are never rebuffered.
+            inline void setParallax(int zIndex, Parallax const &p) {
+                if (zIndex < -499 || zIndex > 500) { return; }
+                parallaxLayers[zIndex + 499] = p;
+                recordLayers();
+            };
+
+            // layers out of range scroll with the world
+            inline Parallax const& getParallax(int zIndex) const {
+                static Parallax const none;
+                return zIndex >= -499 && zIndex <= 500 ? parallaxLayers[zIndex + 499] : none;
+            };
+
+            // Block until the last submitted frame is drawn.
+            // Afterwards the framebuffer and picking texture can be read from the main context. Calling it again before the next submit returns right away.
+            void wait();
+
+            // Render the recorded frame to the framebuffer's current region.
+            inline void setTarget(FrameBuffer const &frameBuffer) {
+                RenderSnapshot &snap = snapshots[1 - front];
+                snap.sceneWidth = frameBuffer.getWidth();
+                snap.sceneHeight = frameBuffer.getHeight();
+                snap.targetWidth = frameBuffer.getTextureWidth();
+                snap.targetHeight = frameBuffer.getTextureHeight();
+            };
+
+            // Say what will be read from the recorded frame once it is drawn.
+            inline void setConsumers(bool sceneVisible, bool picking) {
+                RenderSnapshot &snap = snapshots[1 - front];
+                snap.sceneVisible = sceneVisible;
+                snap.picking = picking;
+            };
+
+            // Would the recorded snapshot draw anything different from the last frame submitted?
+            // A target that was culled last frame and is read now also needs a frame.
+            inline bool needsFrame() const {
+                RenderSnapshot const &snap = snapshots[1 - front];
+                return snap.hasWork() || snap.sceneWidth != lastWidth || snap.sceneHeight != lastHeight ||
+                        snap.camera.proj != lastCamera.proj || snap.camera.view != lastCamera.view ||
+                        (snap.sceneVisible && !lastVisible) || (snap.picking && !lastPicking);
+            };
+
+            // Hand the recorded snapshot over to the render thread. wait() must be called first.
+            void submit();
+
+            // Binds made and skipped by the render thread during the last frame it drew.
+            // Only call after wait().
+            inline GLState::Counters const& getStats() const { return stats; };
+            inline GLDebug::CallCounts const& getCalls() const { return calls; };
+
+            // GPU time in ms of the scene passes for the latest frame that finished on the GPU.
+            // Returns 0 if no new frame was measured. Only call after wait().
+            inline float getGPUTime() const { return gpuTime; };
+
+            // Draws, batches, uploads, and layers of the last frame drawn.
+            // Only call after wait().
+            inline RenderStats::FrameStats const& getFrameStats() const { return frameStats; };
+
+            // RENDER_STATS_HISTORY samples starting from the oldest at index (wrapping around).
+            // Only call after wait().
+            inline RenderStats::FrameSample const* getHistory(int &index) const {
+                index = historyIndex;
+                return history;
+            };
+
+            // Passes of the last frame drawn with their latest GPU time in ms (negative = culled).
+            // Only call after wait().
+            inline PassTiming const* getPassTimings(int &numPasses) const {
+                numPasses = numPassTimings;
+                return passTimings;
+            };
+
+            // Stop the thread and free its context.
+            void destroy();
+    };
+}
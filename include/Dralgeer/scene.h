@@ -4,7 +4,10 @@
 #include "framebuffer.h"
 #include "gizmo.h"
 #include "render.h"
+#include "renderthread.h"
 #include "event.h"
+#include "decal.h"
+#include "discovery.h"
 #include <Zeta2D/physicshandler.h>
 
 namespace Dralgeer {
@@ -78,7 +81,14 @@ namespace Dralgeer {
             
             void update(float &dt);
 
-            inline void render(Shader const &currShader) { renderer.render(currShader, camera); };
+            inline void render(Shader const &currShader) {
+                GLState::setCamera(camera);
+
+                // default.glsl outputs premultiplied alpha (see Materials)
+                glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+                renderer.render(currShader);
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            };
 
             // add a sprite renderer to the subscene
             inline void addSprite(SpriteRenderer* spr) {
@@ -167,13 +177,17 @@ namespace Dralgeer {
             bool imGuiSetup = 1;
 
             EditorCamera editorCamera;
-            GridLines gridLines;
             MouseControls mouseControls;
             GizmoSystem gizmoSystem;
 
-            EditorRenderer renderer;
+            RenderThread* renderThread = nullptr; // the sprites are drawn by the render thread from what is recorded here
             Zeta::Handler physicsHandler;
 
+            DecalLayer decalLayers[DECAL_MAX_LAYERS]; // saved alongside the scene
+            int numDecalLayers = 0;
+
+            DiscoveryMap discovery; // cells revealed while playing (the fog texture only mirrors it while the scene is running)
+
 
             // * ====================
             // * Helper Functions
@@ -220,15 +234,18 @@ namespace Dralgeer {
             // * Normal Functions
             // * ====================
 
-            void init();
+            void init(RenderThread* renderThread);
             void imGui();
 
             inline void start() {
                 for (int i = 0; i < numObjects; ++i) {
                     gameObjects[i]->start();
-                    renderer.add(gameObjects[i]->sprite);
+                    renderThread->record(SPRITE_ADD, gameObjects[i]->sprite);
                 }
 
+                for (int i = 0; i < numDecalLayers; ++i) { renderThread->record(SPRITE_ADD, decalLayers[i].quad); }
+                Discovery::setActive(&discovery);
+
                 running = 1;
             };
 
@@ -237,7 +254,7 @@ namespace Dralgeer {
                 
                 if (running) {
                     go->start();
-                    renderer.add(go->sprite);
+                    renderThread->record(SPRITE_ADD, go->sprite);
                 }
             };
 
@@ -250,8 +267,29 @@ namespace Dralgeer {
                 return nullptr;
             };
 
+            // Add a decal layer covering size world units from origin.
+            // Returns the layer's index or -1 if the scene has no layers left.
+            int addDecalLayer(glm::vec2 const &origin, glm::vec2 const &size, int zIndex);
+
+            // Bake a decal into a layer. It shows up in the next frame captured.
+            inline void stampDecal(int layer, Decal const &decal) {
+                if (layer < 0 || layer >= numDecalLayers) { return; }
+                decalLayers[layer].stamp(decal);
+            };
+
+            inline void clearDecals(int layer) {
+                if (layer < 0 || layer >= numDecalLayers) { return; }
+                decalLayers[layer].clear();
+            };
+
+            // Hide the whole level under the fog again.
+            inline void resetDiscovery() { discovery.clear(); };
+
             void update(float &dt, bool wantCapture, bool physicsUpdate);
-            inline void render(Shader const &currShader) { renderer.render(currShader, camera); };
+
+            // Record everything that changed this frame into the render thread's snapshot.
+            // Call after everything that could modify the scene this frame.
+            void capture(bool renderGrid);
 
             void onNotify(EventType event, GameObject* go);
             void exportScene();
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "component.h"
+
+namespace Dralgeer {
+    struct Glyph {
+        glm::vec2 offset; // bottom left corner of the glyph's quad relative to the pen (in font pixels)
+        glm::vec2 size; // size of the glyph's quad (in font pixels)
+        glm::vec2 texCoords[4]; // laid out like a Sprite's
+        float advance; // how far to move the pen afterwards (in font pixels)
+    };
+
+    // Signed distance field font made from a .ttf file.
+    // Every printable ASCII glyph is rasterized once into an atlas at FONT_PIXEL_HEIGHT. Since the atlas stores distances to the
+    // glyph's edge instead of coverage, the text stays sharp when drawn much larger or smaller than that.
+    class Font {
+        public:
+            Texture* texture = nullptr; // atlas (the distance field is stored in the alpha channel)
+            Glyph glyphs[FONT_NUM_GLYPHS];
+            float kerning[FONT_NUM_GLYPHS * FONT_NUM_GLYPHS]; // extra advance between each pair of glyphs (in font pixels)
+            float lineHeight; // distance between baselines (in font pixels)
+
+            // ! Only for debugging
+            std::string filepath;
+
+            inline Font() {};
+
+            // ? Do not allow for reassignment or construction of a Font from another Font
+
+            inline Font(Font const &font) { throw std::runtime_error("[ERROR] Cannot constructor a Font from another Font."); };
+            inline Font(Font &&font) { throw std::runtime_error("[ERROR] Cannot constructor a Font from another Font."); };
+            inline Font& operator = (Font const &font) { throw std::runtime_error("[ERROR] Cannot reassign a Font object. Do NOT use the '=' operator."); };
+            inline Font& operator = (Font &&font) { throw std::runtime_error("[ERROR] Cannot reassign a Font object. Do NOT use the '=' operator."); };
+
+            inline ~Font() { delete texture; };
+
+            // Rasterize the font and upload its atlas.
+            void init(std::string const &filepath);
+
+            // Returns nullptr for characters that are not in the font.
+            inline Glyph const* getGlyph(char c) const {
+                int i = c - FONT_FIRST_CHAR;
+                return i >= 0 && i < FONT_NUM_GLYPHS ? &glyphs[i] : nullptr;
+            };
+
+            inline float getKerning(char a, char b) const {
+                int i = a - FONT_FIRST_CHAR, j = b - FONT_FIRST_CHAR;
+                if (i < 0 || i >= FONT_NUM_GLYPHS || j < 0 || j >= FONT_NUM_GLYPHS) { return 0.0f; }
+                return kerning[i*FONT_NUM_GLYPHS + j];
+            };
+    };
+
+    // A string drawn with a Font.
+    // Each character is a SpriteRenderer so text goes through the same batches as every other sprite. The glyph sprites are all made
+    // up front (one per character of maxLength) and the unused ones are collapsed to nothing, so add every one of them to the renderer
+    // once. The layout is only redone when the text changes and only the glyphs that moved are marked dirty, so text that does not
+    // change costs nothing per frame.
+    class Text {
+        private:
+            Font* font = nullptr;
+            std::string str;
+            glm::vec2 pos; // start of the first line's baseline
+            float size = FONT_PIXEL_HEIGHT; // height of a line in world units
+            glm::vec4 color = glm::vec4(1, 1, 1, 1);
+            int zIndex = 0;
+
+            void layout();
+
+        public:
+            SpriteRenderer** glyphs = nullptr;
+            int maxLength = 0; // the text is cut off after this many characters
+
+            inline Text() {};
+
+            // ? Do not allow for reassignment or construction of a Text from another Text
+
+            inline Text(Text const &text) { throw std::runtime_error("[ERROR] Cannot constructor a Text from another Text."); };
+            inline Text(Text &&text) { throw std::runtime_error("[ERROR] Cannot constructor a Text from another Text."); };
+            inline Text& operator = (Text const &text) { throw std::runtime_error("[ERROR] Cannot reassign a Text object. Do NOT use the '=' operator."); };
+            inline Text& operator = (Text &&text) { throw std::runtime_error("[ERROR] Cannot reassign a Text object. Do NOT use the '=' operator."); };
+
+            // The glyphs must be removed from any renderer they were added to first.
+            inline ~Text() {
+                for (int i = 0; i < maxLength; ++i) { delete glyphs[i]; }
+                delete[] glyphs;
+            };
+
+            // * ====================
+            // * Normal Functions
+            // * ====================
+
+            void init(Font* font, int maxLength, glm::vec2 const &pos, float size, int zIndex = 0);
+
+            // * Each of these only touches the glyphs if something actually changed.
+
+            inline void setText(std::string const &str) {
+                if (this->str == str) { return; }
+                this->str = str;
+                layout();
+            };
+
+            inline void setPosition(glm::vec2 const &pos) {
+                if (this->pos == pos) { return; }
+                this->pos = pos;
+                layout();
+            };
+
+            inline void setSize(float size) {
+                if (this->size == size) { return; }
+                this->size = size;
+                layout();
+            };
+
+            // Changing the color does not affect the layout so it only rewrites the color.
+            void setColor(glm::vec4 const &color);
+
+            inline std::string const& getText() const { return str; };
+    };
+}
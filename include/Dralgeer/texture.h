@@ -10,6 +10,7 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <GLM/glm/glm.h>
+#include "gpu.h"
 
 namespace Dralgeer {
     class Shader {
@@ -20,6 +21,13 @@ namespace Dralgeer {
             std::string filepath;
 
             int shaderID;
+            std::unordered_map<std::string, int> uniforms; // uniform locations (resolved when the shader is linked)
+
+            // * Returns -1 if the shader has no uniform with that name (uploading to -1 is ignored by OpenGL).
+            inline int getLocation(char const* name) const {
+                auto loc = uniforms.find(name);
+                return loc == uniforms.end() ? -1 : loc->second;
+            };
 
         public:
             Shader() {};
@@ -31,63 +39,66 @@ namespace Dralgeer {
             void compile();
 
             // * Do not call if already in use.
-            inline void use() const { glUseProgram(shaderID); };
+            inline void use() const { GLState::useProgram(shaderID); };
 
-            inline void detach() const { glUseProgram(0); };
+            inline void detach() const { GLState::useProgram(0); };
 
 
             // ? Note: OpenGL expects matrices in column major order.
 
             // * Only call if already in use.
             inline void uploadMat4(char const* name, glm::mat4 const &mat) const {
-                int loc = glGetUniformLocation(shaderID, name);
+                int loc = getLocation(name);
                 glUniformMatrix4fv(loc, 1, 0, &mat[0][0]); // todo glm says to do 1, but the actual size is 16
             };
             
             // * Only call if already in use.
             inline void uploadMat3(char const* name, glm::mat3 const &mat) const {
-                int loc = glGetUniformLocation(shaderID, name);
+                int loc = getLocation(name);
                 glUniformMatrix3fv(loc, 1, 0, &mat[0][0]);
             };
 
             // * Only call if already in use.
             inline void uploadVec4(char const* name, glm::vec4 const &vec) const {
-                int loc = glGetUniformLocation(shaderID, name);
+                int loc = getLocation(name);
                 glUniform4f(loc, vec.x, vec.y, vec.z, vec.w);
             };
 
             // * Only call if already in use.
             inline void uploadVec3(char const* name, glm::vec3 const &vec) const {
-                int loc = glGetUniformLocation(shaderID, name);
+                int loc = getLocation(name);
                 glUniform3f(loc, vec.x, vec.y, vec.z);
             };
 
             // * Only call if already in use.
             inline void uploadVec2(char const* name, glm::vec2 const &vec) const {
-                int loc = glGetUniformLocation(shaderID, name);
+                int loc = getLocation(name);
                 glUniform2f(loc, vec.x, vec.y);
             };
 
             // * Only call if already in use.
             inline void uploadFloat(char const* name, float n) const {
-                int loc = glGetUniformLocation(shaderID, name);
+                int loc = getLocation(name);
                 glUniform1f(loc, n);
             };
 
             // * To upload a texture, use this with the proper slot put as the parameter n.
             // * Only call if already in use.
             inline void uploadInt(char const* name, int n) const {
-                int loc = glGetUniformLocation(shaderID, name);
+                int loc = getLocation(name);
                 glUniform1i(loc, n);
             };
 
             // * Only call if already in use.
             inline void uploadIntArr(char const* name, int nums[], int size) const {
-                int loc = glGetUniformLocation(shaderID, name);
+                int loc = getLocation(name);
                 glUniform1iv(loc, size, nums);
             };
 
-            ~Shader() { glDeleteProgram(shaderID); };
+            ~Shader() {
+                glDeleteProgram(shaderID);
+                GLState::forgetProgram(shaderID);
+            };
     };
 
 
@@ -96,14 +107,16 @@ namespace Dralgeer {
             std::string filepath;
             int width, height;
             unsigned int texID; // ! DO NOT serialize
+            bool sdf = 0; // holds a signed distance field in its alpha channel (e.g. a font atlas)
+            bool premultiplied = 0; // color is already multiplied by alpha (e.g. a decal layer)
 
             Texture() {};
 
             void init(std::string const &filepath);
             void init(int width, int height);
-            inline void bind() const { glBindTexture(GL_TEXTURE_2D, texID); };
-            inline void unbind() const { glBindTexture(GL_TEXTURE_2D, 0); };
+            inline void bind() const { GLState::bindTexture(GL_TEXTURE_2D, texID); };
+            inline void unbind() const { GLState::bindTexture(GL_TEXTURE_2D, 0); };
 
-            ~Texture() { glDeleteTextures(1, &texID); };
+            ~Texture() { GPU::deleteTextures(1, &texID); };
     };
 }
@@ -47,7 +47,7 @@
 // - fix the rule of 5 operators for the classes I have them for
 // // - fix the renderer thing by making it a class and adding the zIndex stuff (test to see if buffering greater than the max buffer size causes an error)
 // - optimize my serialization format
-// - Font Renderer
+// // - Font Renderer
 // - Scene Hierarchy (allow for scene progression and for subscenes if one was to enter a subarea for instance)
 // - Scene Panel which implies we make a scene selector in the level editor scene (flesh out scene selector and saver basically)
 // - Update the level editor to only allow for the import of root scenes (root scenes can store additional scenes and would not be imported by any other scene)
@@ -88,11 +88,19 @@
 // todo run valgrind on this to catch memory leaks
 // todo enforce the max string size for the serializer
 
+#include <atomic>
 #include "event.h"
 #include "imguilayer.h"
 #include "listeners.h"
 #include "render.h"
 #include "debugdraw.h"
+#include "animation.h"
+#include "material.h"
+#include "decal.h"
+#include "renderthread.h"
+#include "renderscale.h"
+#include "framepacing.h"
+#include "framecapture.h"
 
 namespace Dralgeer {
     struct WindowData {
@@ -110,17 +118,33 @@ namespace Dralgeer {
         extern ImGuiLayer imGuiLayer;
         extern FrameBuffer frameBuffer;
         extern PickingTexture* pickingTexture;
+        extern RenderThread renderThread;
 
         // static bool initGamepadState = 1;
         // static GLFWgamepadstate gamepadState;
 
         extern bool runtimePlaying; // Is the scene being played? (i.e. are physics active)
 
+        // * Idle loop.
+        // ? While nothing is changing the loop blocks on events instead of redrawing the scene at the refresh rate.
+        // ? ImGui is still drawn when the loop wakes up, but it just shows the framebuffer from the last frame drawn.
+        extern bool idleEnabled;
+        extern std::atomic<int> activeFrames; // frames left to draw before the loop can go idle
+
+        // Keep the loop awake for a few frames. Safe to call from any thread.
+        inline void wake() {
+            activeFrames = IDLE_GRACE_FRAMES;
+            glfwPostEmptyEvent(); // in case the main thread is blocked waiting for events
+        };
+
         inline void changeScene(ROOT_SCENE scene) {
             switch(scene) {
                 case LEVEL_EDITOR_SCENE: {
+                    // the old scene's sprites are about to be freed so have the render thread drop its copies of them
+                    renderThread.clear();
+
                     LevelEditorScene* newScene = new LevelEditorScene();
-                    newScene->init();
+                    newScene->init(&renderThread);
                     newScene->importScene();
                     newScene->start();
 
@@ -131,6 +155,7 @@ namespace Dralgeer {
 
                     currScene.scene = newScene;
                     currScene.type = LEVEL_EDITOR_SCENE;
+                    activeFrames = IDLE_GRACE_FRAMES;
 
                     break;
                 }
@@ -155,26 +180,50 @@ namespace Dralgeer {
             glfwWindowHint(GLFW_RESIZABLE, 1);
             glfwWindowHint(GLFW_MAXIMIZED, 1);
 
+            #ifdef DRALGEER_GL_DEBUG
+                glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, 1); // so KHR_debug reports everything
+            #endif
+
             // create the window
             window = glfwCreateWindow(data.width, data.height, data.title.c_str(), NULL, NULL);
             if (!window) { throw std::runtime_error("The window failed to be created."); }
 
             glfwMakeContextCurrent(window); // make the window's context current
             glfwSetWindowUserPointer(window, &data); // add the data as a pointer to the window
-            glfwSwapInterval(1); // enable v-sync
             glfwShowWindow(window); // show the window
 
             // initialize glew
             if (glewInit() != GLEW_OK) { throw std::runtime_error("GLEW failed to initialize."); }
 
+            // GL 3.3 only promises 16 samplers per stage so make sure the sprite shader can link before anything is drawn with it
+            int fragmentUnits = 0, combinedUnits = 0;
+            glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &fragmentUnits);
+            glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &combinedUnits);
+
+            if (fragmentUnits < SPRITE_FRAGMENT_SAMPLERS || combinedUnits < NUM_TEX_SLOTS) {
+                throw std::runtime_error("[ERROR] The GPU supports " + std::to_string(fragmentUnits) + " textures per fragment shader and " +
+                        std::to_string(combinedUnits) + " in total, but the renderer needs " + std::to_string(SPRITE_FRAGMENT_SAMPLERS) +
+                        " and " + std::to_string(NUM_TEX_SLOTS) + ".");
+            }
+
+            GPU::init();
+            GLDebug::init();
+
+            // v-sync by default (can be changed from the Debug menu)
+            FramePacing::init(PACING_VSYNC);
+
             // setup callbacks
             // windows
             glfwSetWindowSizeCallback(window, [](GLFWwindow* window, int width, int height) {
                 WindowData& data = *(WindowData*) glfwGetWindowUserPointer(window);
                 data.width = width;
                 data.height = height;
+                InputListener::notify();
             });
 
+            // the window's contents were lost (e.g. it was uncovered) so it has to be drawn again even while idle
+            glfwSetWindowRefreshCallback(window, [](GLFWwindow*) { InputListener::received = 1; }); // not input so it is not timed
+
             // mouse
             glfwSetCursorPosCallback(window, MouseListener::cursor_position_callback);
             glfwSetMouseButtonCallback(window, MouseListener::mouse_button_callback);
@@ -191,17 +240,25 @@ namespace Dralgeer {
             glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
             // frame buffer config
-            frameBuffer.init(1920, 1080);
+            // the scene's framebuffer follows the size of the game viewport from here on
+            frameBuffer.init(data.width, data.height);
             pickingTexture = new PickingTexture();
             pickingTexture->init(1920, 1080);
-            glViewport(0, 0, 1920, 1080);
 
             // initialize imgui
             imGuiLayer.init(window, pickingTexture);
 
+            // start drawing the scene on its own thread
+            Animation::start();
+            Materials::start();
+            Decals::start();
+            Discovery::start();
+            FrameCapture::start();
+            renderThread.init(window, frameBuffer, *pickingTexture);
+
             // initialize scene
             LevelEditorScene* scene = new LevelEditorScene();
-            scene->init();
+            scene->init(&renderThread);
             scene->importScene();
             scene->start();
             currScene.scene = scene;
@@ -211,50 +268,40 @@ namespace Dralgeer {
         inline void run() {
             float startTime = (float) glfwGetTime(), endTime;
             float dt = 0.0f;
-
-            DebugDraw::start();
-
-            Shader defaultShader = *(AssetPool::getShader("../../assets/shaders/default.glsl"));
-            Shader pickingShader = *(AssetPool::getShader("../../assets/shaders/pickingShader.glsl"));
+            float frameTime = 0.0f; // length of the last iteration
+            bool drewLastFrame = 0; // was a frame handed to the render thread last iteration
+            double queuedInput = 0.0; // oldest input handled by the frame the render thread is drawing
 
             // * Game Loop
+            // ? The render thread draws frame N while this thread simulates frame N + 1.
             while(!glfwWindowShouldClose(window)) {
                 // Poll for events and update
-                glfwPollEvents();
+                // if nothing has changed for a while, sleep until something happens instead
+                if (idleEnabled && activeFrames <= 0 && !runtimePlaying) { glfwWaitEventsTimeout(IDLE_WAIT_TIMEOUT); }
+                else { glfwPollEvents(); }
+
+                // * ------ Frame timing ------
+                // ? A scene frame submitted this iteration is drawn during the next one and shown by the next iteration's present.
+                // ? Anything that did not submit a frame (e.g. ImGui) shows its result with this iteration's present.
+
+                double frameStart = glfwGetTime();
+                double shownInput = queuedInput; // oldest input whose result is shown by this iteration's present
+                double input = InputListener::takeInputTime();
+                queuedInput = 0.0;
+
+                // anything held down can change the scene every frame without sending any events
+                if (InputListener::consume() || KeyListener::keysDown || MouseListener::mButtonsDown) { activeFrames = IDLE_GRACE_FRAMES; }
 
                 // determine the activeScene's type
                 switch(currScene.type) {
                     case LEVEL_EDITOR_SCENE: {
                         LevelEditorScene* activeScene = (LevelEditorScene*) currScene.scene;
 
-                        // render picking texture
-                        glDisable(GL_BLEND);
-                        pickingTexture->enableWriting();
-
-                        glViewport(0, 0, 1920, 1080);
-                        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-                        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-                        activeScene->render(pickingShader);
-
-                        pickingTexture->disableWriting();
-                        glEnable(GL_BLEND);
-
-                        // render the visual for the scene
-                        DebugDraw::beginFrame();
-                        frameBuffer.bind();
-
-                        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-                        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-                        glEnable(GL_DEPTH_TEST);
-
-                        // draw the scene
-                        DebugDraw::draw(activeScene->camera);
-                        activeScene->render(defaultShader);
-
                         // todo put this segment in the dt loop when I set it up -------------------
                         // update the scene
+                        DebugDraw::beginFrame();
                         activeScene->update(dt, imGuiLayer.gameViewWindow.getWantCaptureMouse(), runtimePlaying);
+                        Particles::update(frameTime);
 
                         // todo add stuff for actually navigating a file system to select different scene
                         // check for hotkeys pressed
@@ -269,12 +316,18 @@ namespace Dralgeer {
                             // todo issue with crashing when this hotkey is used
                             // todo this only fails when the LevelEditorScene destructor is called
                             changeScene(LEVEL_EDITOR_SCENE);
+                            activeScene = (LevelEditorScene*) currScene.scene;
                         }
 
                         // -------------------------------------------------------------------------
 
-                        glDisable(GL_DEPTH_TEST);
-                        frameBuffer.unbind();
+                        // the last frame has to be finished before ImGui can display it or the picking texture can be read
+                        renderThread.wait();
+                        if (drewLastFrame) { RenderScale::update(renderThread.getGPUTime()); }
+                        FrameCapture::update(frameBuffer, drewLastFrame); // before the framebuffer can be resized
+                        Animation::update();
+                        bool materialsChanged = Materials::update();
+                        Decals::collect();
 
                         // clear the main screen's background
                         glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
@@ -282,7 +335,33 @@ namespace Dralgeer {
 
                         // MouseListener and ImGui updates
                         MouseListener::updateWorldCoords(activeScene->camera);
-                        imGuiLayer.update(dt, activeScene, currScene.type, frameBuffer.getTextureID(), data.width, data.height);
+                        imGuiLayer.update(dt, activeScene, currScene.type, frameBuffer, data.width, data.height);
+
+                        // ImGui has drawn the last frame so the region rendered to can change for the next one
+                        frameBuffer.resize(RenderScale::apply(imGuiLayer.gameViewWindow.getViewWidth()),
+                                RenderScale::apply(imGuiLayer.gameViewWindow.getViewHeight()));
+                        renderThread.setTarget(frameBuffer);
+
+                        // the picking texture is only drawn while the mouse is over the scene (PropertiesWindow reads it on a click)
+                        renderThread.setConsumers(imGuiLayer.gameViewWindow.isVisible(),
+                                imGuiLayer.gameViewWindow.isVisible() && imGuiLayer.gameViewWindow.getWantCaptureMouse());
+
+                        // ImGui can change the scene through events so get it again before handing this frame over
+                        Particles::upload();
+                        Discovery::upload();
+                        ((LevelEditorScene*) currScene.scene)->capture(!runtimePlaying);
+
+                        // only draw the scene if this frame would look any different from the last one
+                        if (runtimePlaying || materialsChanged || renderThread.needsFrame()) { activeFrames = IDLE_GRACE_FRAMES; }
+
+                        drewLastFrame = activeFrames > 0 || !idleEnabled;
+                        if (drewLastFrame) {
+                            renderThread.submit();
+                            queuedInput = input;
+
+                        } else if (shownInput == 0.0) { shownInput = input; }
+
+                        if (activeFrames > 0) { --activeFrames; }
 
                         break;
                     }
@@ -300,20 +379,24 @@ namespace Dralgeer {
                     glfwMakeContextCurrent(backupWindow);
                 }
 
+                double presentStart = glfwGetTime();
+                FramePacing::limit();
                 glfwSwapBuffers(window); // swaps front and back buffers
                 MouseListener::endFrame();
                 
                 // handle the dt value
                 endTime = (float) glfwGetTime();
-                dt += endTime - startTime;
+
+                double presentEnd = glfwGetTime();
+                FramePacing::record({(endTime - startTime) * 1000.0f, (float) ((presentStart - frameStart) * 1000.0),
+                        (float) ((presentEnd - presentStart) * 1000.0), shownInput > 0.0 ? (float) ((presentEnd - shownInput) * 1000.0) : -1.0f});
+
+                frameTime = endTime - startTime;
+                dt += frameTime;
                 startTime = endTime;
 
-                // * Check for errors to make it easier to debug
-                // ! this will be removed in the final build
-                // GLenum err;
-                // while((err = glGetError()) != GL_NO_ERROR) {
-                //     std::cout << "[Error] " << err << "\n";
-                // }
+                // * Check for errors to make it easier to debug (does nothing in release builds)
+                GLDebug::endFrame();
             }
         };
 
@@ -323,9 +406,19 @@ namespace Dralgeer {
                 case LEVEL_EDITOR_SCENE: { delete (LevelEditorScene*) currScene.scene; break; }
             }
 
+            renderThread.destroy();
+            FrameCapture::destroy();
             DebugDraw::destroy();
+            Animation::destroy();
+            Materials::destroy();
+            Decals::destroy();
+            Discovery::destroy();
+            Lighting::destroy();
+            Particles::destroy();
+            GLState::destroy();
             AssetPool::destroy();
             imGuiLayer.dispose();
+            GLDebug::report(); // everything the engine made should be freed by now
             glfwDestroyWindow(window);
             glfwSetErrorCallback(NULL);
             glfwTerminate();
@@ -148,6 +148,20 @@ namespace Zeta {
     };
 
 
+    // Contact data kept around after a step so it can be inspected (i.e. by a debug overlay).
+    struct DebugContact {
+        ZMath::Vec2D point; // contact point
+        ZMath::Vec2D normal; // collision normal
+        float pDist; // penetration distance
+    };
+
+    struct DebugContacts {
+        DebugContact* contacts = nullptr; // contacts found during the last step
+        int capacity = 0; // current max capacity
+        int count = 0; // number of contacts
+    };
+
+
     // * ========================
     // * Main Physics Handler
     // * ========================
@@ -166,6 +180,7 @@ namespace Zeta {
             RkCollisionWrapper rkColWrapper; // collision information involving rigid and kinematic body collisions
             SkCollisionWrapper skColWrapper; // collision information involving static and kinematic body collisions
             KinematicCollisionWrapper kColWrapper; // collision information involving kinematic body collisions
+            DebugContacts debugContacts; // contacts from the last step (only filled when recordContacts is set)
             float updateStep; // amount of dt to update after
             static const int IMPULSE_ITERATIONS = 6; // number of times to apply the impulse update.
 
@@ -314,6 +329,25 @@ namespace Zeta {
                 kColWrapper.manifolds[kColWrapper.count++] = manifold;
             };
 
+            // Copy the contact points of the manifolds passed in to debugContacts.
+            inline void saveContacts(Collisions::CollisionManifold const* manifolds, int count) {
+                for (int i = 0; i < count; ++i) {
+                    for (int j = 0; j < manifolds[i].numPoints; ++j) {
+                        if (debugContacts.count == debugContacts.capacity) {
+                            debugContacts.capacity = debugContacts.capacity ? 2*debugContacts.capacity : halfStartingSlots;
+                            DebugContact* temp = new DebugContact[debugContacts.capacity];
+
+                            for (int k = 0; k < debugContacts.count; ++k) { temp[k] = debugContacts.contacts[k]; }
+
+                            delete[] debugContacts.contacts;
+                            debugContacts.contacts = temp;
+                        }
+
+                        debugContacts.contacts[debugContacts.count++] = {manifolds[i].contactPoints[j], manifolds[i].normal, manifolds[i].pDist};
+                    }
+                }
+            };
+
             inline void clearCollisions() {
                 // ? We do not need to check for nullptrs because if this function is reached it is guarenteed none of the pointers inside of here will be NULL
 
@@ -400,6 +434,7 @@ namespace Zeta {
             // * =====================
 
             ZMath::Vec2D g; // gravity
+            bool recordContacts = 0; // keep the contacts of the last step for debugging. Costs nothing when not set.
 
 
             // * ===================================
@@ -530,9 +565,23 @@ namespace Zeta {
                     for (int i = 0; i < kColWrapper.count; ++i) { delete[] kColWrapper.manifolds[i].contactPoints; }
                     delete[] kColWrapper.manifolds;
                 }
+
+                delete[] debugContacts.contacts;
             };
 
 
+            // * ============================
+            // * Read-only Access
+            // * ============================
+
+            inline RigidBodies const& getRigidBodies() const { return rbs; };
+            inline StaticBodies const& getStaticBodies() const { return sbs; };
+            inline KinematicBodies const& getKinematicBodies() const { return kbs; };
+
+            // Contacts found during the most recent step. Only filled while recordContacts is set.
+            inline DebugContacts const& getDebugContacts() const { return debugContacts; };
+
+
             // * ============================
             // * RigidBody List Functions
             // * ============================
@@ -769,6 +818,15 @@ namespace Zeta {
                         }
                     }
 
+                    if (recordContacts) {
+                        debugContacts.count = 0;
+                        saveContacts(colWrapper.manifolds, colWrapper.count);
+                        saveContacts(staticColWrapper.manifolds, staticColWrapper.count);
+                        saveContacts(rkColWrapper.manifolds, rkColWrapper.count);
+                        saveContacts(skColWrapper.manifolds, skColWrapper.count);
+                        saveContacts(kColWrapper.manifolds, kColWrapper.count);
+                    }
+
                     clearCollisions();
 
                     // Update our rigidbodies
@@ -0,0 +1,19 @@
+#include <Dralgeer/animation.h>
+
+namespace Dralgeer {
+    namespace Animation {
+        AnimationClip* clips = new AnimationClip[ANIM_START_CAPACITY];
+        int numClips = 0;
+        int clipCapacity = ANIM_START_CAPACITY;
+
+        float* frames = new float[ANIM_START_CAPACITY * 4];
+        int numFrames = 0;
+        int frameCapacity = ANIM_START_CAPACITY;
+
+        unsigned int clipBuffer, clipTex;
+        unsigned int frameBuffer, frameTex;
+        bool started = 0, rebuffer = 0;
+
+        float time = 0.0f;
+    }
+}
@@ -9,6 +9,7 @@
 #include <Dralgeer/debugdraw.h>
 #include <Dralgeer/prefabs.h>
 #include <Dralgeer/event.h>
+#include <Dralgeer/material.h>
 
 namespace Dralgeer {
     // * =====================================================================
@@ -26,6 +27,9 @@ namespace Dralgeer {
         }
 
         if (DImGui::colorPicker4("Color Picker", color)) { isDirty = 1; }
+
+        int id = material;
+        if (ImGui::InputInt("Material", &id)) { Materials::use(this, id); }
     };
 
     // * =====================================================================
@@ -82,28 +86,83 @@ namespace Dralgeer {
     // * =====================================================================
     // * GridLines Stuff
 
-    void GridLines::update(Camera const &cam) {
-        int firstX = ((int) (cam.pos.x * cam.zoom) - GRID_WIDTH);
-        int firstY = ((int) (cam.pos.y * cam.zoom) - GRID_HEIGHT);
-        int width = ((int) (cam.projSize.x * cam.zoom)) + 2 * GRID_WIDTH;
-        int height = ((int) (cam.projSize.y * cam.zoom)) + 2 * GRID_HEIGHT;
+    // * ====================
+    // * Rule of 5 Stuff
+    // * ====================
+
+    GridLines::GridLines(GridLines &&gl) : shader(gl.shader), vaoID(gl.vaoID), vboID(gl.vboID), started(gl.started) {
+        id = IDCounter::componentID++;
+        gl.started = 0;
+    };
+
+    GridLines& GridLines::operator = (GridLines const &) { return *this; }; // nothing to copy, the quad is created lazily
+
+    GridLines& GridLines::operator = (GridLines &&gl) {
+        if (this != &gl) {
+            if (started) {
+                glDeleteVertexArrays(1, &vaoID);
+                glDeleteBuffers(1, &vboID);
+            }
+
+            shader = gl.shader;
+            vaoID = gl.vaoID;
+            vboID = gl.vboID;
+            started = gl.started;
+            gl.started = 0;
+        }
+
+        return *this;
+    };
+
+    GridLines::~GridLines() {
+        if (started) {
+            glDeleteVertexArrays(1, &vaoID);
+            glDeleteBuffers(1, &vboID);
+            GLState::forgetVertexArray(vaoID);
+            GLState::forgetBuffer(vboID);
+        }
+    };
+
+    // * =====================
+    // * Normal Functions
+    // * =====================
+
+    void GridLines::start() {
+        if (!shader) { shader = AssetPool::getShader("../../assets/shaders/grid.glsl"); }
+
+        // full viewport quad in normalized device coordinates
+        float vertices[8] = {1.0f, 1.0f, 1.0f, -1.0f, -1.0f, 1.0f, -1.0f, -1.0f};
 
-        int vertLines = ((int) (cam.projSize.x * cam.zoom)/GRID_WIDTH) + 2;
-        int horzLines = ((int) (cam.projSize.y * cam.zoom)/GRID_HEIGHT) + 2;
+        glGenVertexArrays(1, &vaoID);
+        GLState::bindVertexArray(vaoID);
+
+        glGenBuffers(1, &vboID);
+        GLState::bindBuffer(GL_ARRAY_BUFFER, vboID);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+        glVertexAttribPointer(0, 2, GL_FLOAT, 0, 2 * sizeof(float), (void*) 0);
+        glEnableVertexAttribArray(0);
+        started = 1;
+    };
+
+    void GridLines::render() {
+        if (!started) { start(); }
 
-        int maxLines = MAX(vertLines, horzLines);
         // glm::vec3 color(0.8549f, 0.4392f, 0.8392f); // violet
         glm::vec3 color(0.8471f, 0.749f, 0.8471f); // thistle
 
-        // todo consider changing how the lines are handled since this would be a decent chunk of data moving between the GPU and CPU
-        // todo  every frame
-        for (int i = 0; i < maxLines; ++i) {
-            int x = firstX + i*GRID_WIDTH;
-            int y = firstY + i*GRID_HEIGHT;
+        shader->use();
+        shader->uploadVec2("uGridSize", glm::vec2(GRID_WIDTH, GRID_HEIGHT));
+        shader->uploadVec3("uColor", color);
 
-            if (i < vertLines) { DebugDraw::addLine2D(glm::vec2(x, firstX), glm::vec2(x, firstY + height), color, 1); }
-            if (i < horzLines) { DebugDraw::addLine2D(glm::vec2(firstX, y), glm::vec2(firstX + width, y), color, 1); }
-        }
+        // the grid should never hide anything drawn after it
+        glDepthMask(GL_FALSE);
+
+        GLState::bindVertexArray(vaoID);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        RenderStats::countDraw();
+
+        glDepthMask(GL_TRUE);
     };
 
     // * =====================================================================
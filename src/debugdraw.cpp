@@ -2,14 +2,19 @@
 
 namespace Dralgeer {
     namespace DebugDraw {
-        Line2D* lines = new Line2D[64];
+        Line2D* lines = new Line2D[DEBUG_START_CAPACITY];
+        float* pVertices = new float[DEBUG_START_CAPACITY * DEBUG_LINE_SIZE];
         int numLines = 0;
-        int capacity = 64;
+        int capacity = DEBUG_START_CAPACITY;
 
-        float vertices[DEBUG_VERTEX_ARR_SIZE];
-        Shader shader;
+        float* tVertices = new float[DEBUG_START_CAPACITY * DEBUG_LINE_SIZE];
+        int numTransient = 0;
+        int tCapacity = DEBUG_START_CAPACITY;
+
+        Shader* shader = nullptr;
 
         unsigned int vaoID, vboID;
+        int gpuCapacity = DEBUG_START_CAPACITY;
         bool started = 0, rebuffer = 0;
     }
 }
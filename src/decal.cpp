@@ -0,0 +1,259 @@
+#include <Dralgeer/decal.h>
+#include <cmath>
+#include <algorithm>
+#include <STB/stb_image.h>
+#include <STB/stb_image_write.h>
+
+namespace Dralgeer {
+    namespace Decals {
+        Shader* shader = nullptr;
+        unsigned int vaoID, vboID;
+        int vboCapacity = 0;
+        bool started = 0;
+
+        namespace {
+            // * Textures of freed layers (dying ones are moved to dead on the next collect and deleted on the one after).
+            Texture** dying = nullptr;
+            int numDying = 0, dyingCapacity = 0;
+
+            Texture** dead = nullptr;
+            int numDead = 0, deadCapacity = 0;
+        }
+
+        void start() {
+            shader = AssetPool::getShader("../../assets/shaders/decal.glsl");
+
+            glGenVertexArrays(1, &vaoID);
+            GLState::bindVertexArray(vaoID);
+
+            glGenBuffers(1, &vboID);
+            GLState::bindBuffer(GL_ARRAY_BUFFER, vboID);
+            glBufferData(GL_ARRAY_BUFFER, DECAL_START_CAPACITY * 6 * DECAL_VERTEX_SIZE * sizeof(float), NULL, GL_STREAM_DRAW);
+            vboCapacity = DECAL_START_CAPACITY;
+
+            glVertexAttribPointer(0, 2, GL_FLOAT, 0, DECAL_VERTEX_SIZE * sizeof(float), (void*) 0);
+            glVertexAttribPointer(1, 2, GL_FLOAT, 0, DECAL_VERTEX_SIZE * sizeof(float), (void*) (2 * sizeof(float)));
+            glVertexAttribPointer(2, 4, GL_FLOAT, 0, DECAL_VERTEX_SIZE * sizeof(float), (void*) (4 * sizeof(float)));
+            glEnableVertexAttribArray(0);
+            glEnableVertexAttribArray(1);
+            glEnableVertexAttribArray(2);
+
+            started = 1;
+        };
+
+        void release(Texture* texture) {
+            if (numDying == dyingCapacity) {
+                dyingCapacity = dyingCapacity ? 2*dyingCapacity : DECAL_MAX_LAYERS;
+                Texture** temp = new Texture*[dyingCapacity];
+                for (int i = 0; i < numDying; ++i) { temp[i] = dying[i]; }
+
+                delete[] dying;
+                dying = temp;
+            }
+
+            dying[numDying++] = texture;
+        };
+
+        void collect() {
+            for (int i = 0; i < numDead; ++i) { delete dead[i]; }
+
+            // the lists are swapped so neither has to be reallocated
+            Texture** temp = dead;
+            int tempCapacity = deadCapacity;
+
+            dead = dying;
+            numDead = numDying;
+            deadCapacity = dyingCapacity;
+
+            dying = temp;
+            numDying = 0;
+            dyingCapacity = tempCapacity;
+        };
+
+        void destroy() {
+            // the render thread is stopped by now
+            for (int i = 0; i < numDead; ++i) { delete dead[i]; }
+            for (int i = 0; i < numDying; ++i) { delete dying[i]; }
+            delete[] dead;
+            delete[] dying;
+            dead = dying = nullptr;
+            numDead = numDying = 0;
+            deadCapacity = dyingCapacity = 0;
+
+            if (!started) { return; }
+
+            glDeleteVertexArrays(1, &vaoID);
+            glDeleteBuffers(1, &vboID);
+            GLState::forgetVertexArray(vaoID);
+            GLState::forgetBuffer(vboID);
+            vboCapacity = 0;
+            started = 0;
+        };
+    }
+
+    // * ====================================================
+    // * DecalLayer Stuff
+
+    DecalLayer::~DecalLayer() {
+        delete[] pending;
+        delete quad;
+        if (texture) { Decals::release(texture); }
+        if (fboID) { glDeleteFramebuffers(1, &fboID); }
+    };
+
+    void DecalLayer::init(glm::vec2 const &origin, glm::vec2 const &size, int zIndex) {
+        this->origin = origin;
+        this->size = size;
+
+        int width = (int) std::fmin(size.x * DECAL_PIXELS_PER_UNIT, DECAL_MAX_TEXTURE_SIZE);
+        int height = (int) std::fmin(size.y * DECAL_PIXELS_PER_UNIT, DECAL_MAX_TEXTURE_SIZE);
+
+        texture = new Texture();
+        texture->init(width < 1 ? 1 : width, height < 1 ? 1 : height);
+        texture->filepath = "decals";
+
+        GPU::textureParameter(texture->texID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        GPU::textureParameter(texture->texID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        glGenFramebuffers(1, &fboID);
+        glBindFramebuffer(GL_FRAMEBUFFER, fboID);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture->texID, 0);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) { throw std::runtime_error("[ERROR] Decal layer framebuffer is not complete.\n"); }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        clear();
+
+        texture->premultiplied = 1; // the sprite shader undoes it before tinting
+
+        quad = new SpriteRenderer();
+        quad->sprite.texture = texture;
+        quad->sprite.width = size.x;
+        quad->sprite.height = size.y;
+        quad->transform.pos = origin;
+        quad->transform.scale = size;
+        quad->transform.zIndex = zIndex;
+        quad->transform.rotation = 0.0f;
+        quad->start();
+    };
+
+    void DecalLayer::flush() {
+        if (!numPending) { return; }
+
+        // * ------ Build the vertices ------
+        // ? Positions are mapped straight to normalized device coordinates of the layer so no projection is needed.
+
+        while (Decals::vboCapacity < numPending) { Decals::vboCapacity *= 2; }
+
+        float* vertices = new float[numPending * 6 * DECAL_VERTEX_SIZE];
+        static int const corners[6] = {0, 1, 2, 2, 3, 0}; // two triangles per decal
+
+        for (int i = 0; i < numPending; ++i) {
+            Decal const &d = pending[i];
+            float c = std::cos(glm::radians(d.rotation)), s = std::sin(glm::radians(d.rotation));
+
+            for (int j = 0; j < 6; ++j) {
+                // same corner order as a sprite's texCoords (top right, bottom right, bottom left, top left)
+                int corner = corners[j];
+                float x = (corner < 2 ? 1.0f : 0.0f) * d.scale.x, y = (corner == 0 || corner == 3 ? 1.0f : 0.0f) * d.scale.y;
+                glm::vec2 world(d.pos.x + x*c - y*s, d.pos.y + x*s + y*c);
+
+                float* v = &vertices[(6*i + j) * DECAL_VERTEX_SIZE];
+                v[0] = 2.0f * (world.x - origin.x)/size.x - 1.0f;
+                v[1] = 2.0f * (world.y - origin.y)/size.y - 1.0f;
+                v[2] = d.sprite.texCoords[corner].x;
+                v[3] = d.sprite.texCoords[corner].y;
+                v[4] = d.color.x;
+                v[5] = d.color.y;
+                v[6] = d.color.z;
+                v[7] = d.color.w;
+            }
+        }
+
+        GLState::bindBuffer(GL_ARRAY_BUFFER, Decals::vboID);
+        glBufferData(GL_ARRAY_BUFFER, Decals::vboCapacity * 6 * DECAL_VERTEX_SIZE * sizeof(float), NULL, GL_STREAM_DRAW); // orphan (or grow) the last flush's storage
+        glBufferSubData(GL_ARRAY_BUFFER, 0, numPending * 6 * DECAL_VERTEX_SIZE * sizeof(float), vertices);
+        RenderStats::uploaded(numPending * 6 * DECAL_VERTEX_SIZE * sizeof(float));
+        delete[] vertices;
+
+        // * ------ Draw ------
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fboID);
+        glViewport(0, 0, texture->width, texture->height);
+
+        // premultiplied "over" keeps both the color and the coverage right for blending the layer over the scene later
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+        GLState::bindVertexArray(Decals::vaoID);
+        Decals::shader->use();
+        Decals::shader->uploadInt("uTexture", 0);
+
+        // one draw per run of decals sharing a texture
+        for (int start = 0, i = 1; i <= numPending; ++i) {
+            if (i < numPending && pending[i].sprite.texture == pending[start].sprite.texture) { continue; }
+
+            Texture const* tex = pending[start].sprite.texture;
+            if (tex) { GLState::bindTexture(0, GL_TEXTURE_2D, tex->texID); }
+            Decals::shader->uploadInt("uTextured", tex != nullptr);
+
+            glDrawArrays(GL_TRIANGLES, 6*start, 6*(i - start));
+            start = i;
+        }
+
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        numPending = 0;
+        quad->isDirty = 1; // the render thread has to draw a frame to show the new decals
+    };
+
+    void DecalLayer::clear() {
+        glBindFramebuffer(GL_FRAMEBUFFER, fboID);
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        numPending = 0;
+        if (quad) { quad->isDirty = 1; }
+    };
+
+    void DecalLayer::save(std::string const &filepath) const {
+        unsigned char* pixels = new unsigned char[texture->width * texture->height * 4];
+
+        GLState::bindTexture(GL_TEXTURE_2D, texture->texID);
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+        // ? The pixels are saved premultiplied (as the layer stores them) so load() can copy them straight back.
+        // the texture's rows start at the bottom and images are loaded flipped, so flip them here
+        // ? stbi_flip_vertically_on_write is global and would also flip the frame captures being encoded on another thread
+        int rowBytes = texture->width * 4;
+        for (int y = 0; y < texture->height/2; ++y) {
+            std::swap_ranges(&pixels[y*rowBytes], &pixels[(y + 1)*rowBytes], &pixels[(texture->height - 1 - y)*rowBytes]);
+        }
+
+        if (!stbi_write_png(filepath.c_str(), texture->width, texture->height, 4, pixels, texture->width * 4)) {
+            std::cout << "[INFO] Decal layer could not be saved to '" << filepath << "'.\n";
+        }
+
+        delete[] pixels;
+    };
+
+    bool DecalLayer::load(std::string const &filepath) {
+        int width, height, channels;
+        stbi_set_flip_vertically_on_load(1);
+        unsigned char* pixels = stbi_load(filepath.c_str(), &width, &height, &channels, 4);
+        if (!pixels) { return 0; }
+
+        if (width != texture->width || height != texture->height) {
+            std::cout << "[INFO] Decal layer '" << filepath << "' does not match the layer's size.\n";
+            stbi_image_free(pixels);
+            return 0;
+        }
+
+        GLState::bindTexture(GL_TEXTURE_2D, texture->texID);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        stbi_image_free(pixels);
+
+        quad->isDirty = 1;
+        return 1;
+    };
+}
@@ -0,0 +1,157 @@
+#include <Dralgeer/discovery.h>
+#include <algorithm>
+#include <cstring>
+
+namespace Dralgeer {
+    // * ====================================================
+    // * DiscoveryMap Stuff
+
+    void DiscoveryMap::init(glm::vec2 const &origin, float cellSize, int width, int height) {
+        this->origin = origin;
+        this->cellSize = cellSize;
+        this->width = width;
+        this->height = height;
+
+        delete[] bits;
+        bits = new uint64_t[(width*height + 63) >> 6];
+        clear();
+    };
+
+    void DiscoveryMap::reveal(glm::vec2 const &center, float radius) {
+        // cells whose centers could be in range
+        int x0 = std::max((int) std::floor((center.x - radius - origin.x)/cellSize), 0);
+        int y0 = std::max((int) std::floor((center.y - radius - origin.y)/cellSize), 0);
+        int x1 = std::min((int) std::floor((center.x + radius - origin.x)/cellSize), width - 1);
+        int y1 = std::min((int) std::floor((center.y + radius - origin.y)/cellSize), height - 1);
+        if (x0 > x1 || y0 > y1) { return; }
+
+        float r2 = radius*radius;
+        bool revealed = 0;
+
+        for (int y = y0; y <= y1; ++y) {
+            float dy = origin.y + (y + 0.5f)*cellSize - center.y;
+
+            for (int x = x0; x <= x1; ++x) {
+                float dx = origin.x + (x + 0.5f)*cellSize - center.x;
+                if (dx*dx + dy*dy > r2) { continue; }
+
+                int i = y*width + x;
+                uint64_t bit = (uint64_t) 1 << (i & 63);
+                if (bits[i >> 6] & bit) { continue; }
+
+                bits[i >> 6] |= bit;
+                revealed = 1;
+            }
+        }
+
+        // standing still in an explored area should not upload anything
+        if (revealed) { markDirty(x0, y0, x1, y1); }
+    };
+
+    void DiscoveryMap::revealRect(glm::vec2 const &min, glm::vec2 const &max) {
+        int x0 = std::max((int) std::floor((min.x - origin.x)/cellSize), 0);
+        int y0 = std::max((int) std::floor((min.y - origin.y)/cellSize), 0);
+        int x1 = std::min((int) std::floor((max.x - origin.x)/cellSize), width - 1);
+        int y1 = std::min((int) std::floor((max.y - origin.y)/cellSize), height - 1);
+        if (x0 > x1 || y0 > y1) { return; }
+
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                int i = y*width + x;
+                bits[i >> 6] |= (uint64_t) 1 << (i & 63);
+            }
+        }
+
+        markDirty(x0, y0, x1, y1);
+    };
+
+    void DiscoveryMap::clear() {
+        std::memset(bits, 0, ((width*height + 63) >> 6) * sizeof(uint64_t));
+        markClean();
+        markDirty(0, 0, width - 1, height - 1);
+    };
+
+    // * ====================================================
+    // * Discovery Stuff
+
+    namespace Discovery {
+        DiscoveryMap* active = nullptr;
+        bool enabled = 0;
+        glm::vec3 fogColor(0.0f, 0.0f, 0.0f);
+        bool changed = 0;
+
+        unsigned int texID;
+        int texWidth = 0, texHeight = 0;
+        unsigned char* texels = nullptr;
+        bool started = 0;
+
+        bool fogActive = 0;
+        glm::vec2 fogOrigin, fogSize;
+        glm::vec3 fogDrawColor;
+
+        void start() {
+            // a cell's fog is blended with its neighbors' so the edge of the explored area is soft
+            glGenTextures(1, &texID);
+            GLState::bindTexture(GL_TEXTURE_2D, texID);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, 1, 1, 0, GL_RED, GL_UNSIGNED_BYTE, 0);
+            texWidth = texHeight = 1;
+
+            started = 1;
+        };
+
+        void upload() {
+            if (!started || !active || !enabled) { return; } // changes pile up in the dirty rectangle until the fog is turned on
+            DiscoveryMap &map = *active;
+
+            // the texture is remade whenever a map of another size becomes active
+            if (map.width != texWidth || map.height != texHeight) {
+                texWidth = map.width;
+                texHeight = map.height;
+
+                GLState::bindTexture(GL_TEXTURE_2D, texID);
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, texWidth, texHeight, 0, GL_RED, GL_UNSIGNED_BYTE, 0);
+
+                delete[] texels;
+                texels = new unsigned char[texWidth * texHeight];
+                map.markDirty(0, 0, map.width - 1, map.height - 1);
+            }
+
+            if (map.dirtyX0 > map.dirtyX1 || map.dirtyY0 > map.dirtyY1) { return; }
+
+            // * ------ Expand the changed rectangle's bits into texels ------
+            // ? The rectangle is packed tightly at the front of the scratch space.
+
+            int w = map.dirtyX1 - map.dirtyX0 + 1, h = map.dirtyY1 - map.dirtyY0 + 1;
+
+            for (int y = 0; y < h; ++y) {
+                for (int x = 0; x < w; ++x) { texels[y*w + x] = map.get(map.dirtyX0 + x, map.dirtyY0 + y) ? 255 : 0; }
+            }
+
+            GLState::bindTexture(GL_TEXTURE_2D, texID);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // rows of single bytes are not 4 byte aligned
+            glTexSubImage2D(GL_TEXTURE_2D, 0, map.dirtyX0, map.dirtyY0, w, h, GL_RED, GL_UNSIGNED_BYTE, texels);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            RenderStats::uploaded(w*h);
+
+            map.markClean();
+            changed = 1;
+        };
+
+        void destroy() {
+            delete[] texels;
+            texels = nullptr;
+            texWidth = texHeight = 0;
+            active = nullptr;
+
+            if (started) {
+                glDeleteTextures(1, &texID);
+                GLState::forgetTexture(texID);
+                started = 0;
+            }
+        };
+    }
+}
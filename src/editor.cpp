@@ -2,6 +2,8 @@
 
 #include <Dralgeer/framebuffer.h>
 #include <Dralgeer/window.h>
+#include <Dralgeer/dimgui.h>
+#include <cstdio>
 
 namespace Dralgeer {
     // * ======================================================
@@ -35,8 +37,8 @@ namespace Dralgeer {
     #pragma GCC diagnostic push
     #pragma GCC diagnostic ignored "-Wint-to-pointer-cast"
 
-    void GameViewWindow::imGui(unsigned int frameBufferTexID) {
-        ImGui::Begin("Game Viewport", NULL, ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoScrollWithMouse | ImGuiWindowFlags_MenuBar);
+    void GameViewWindow::imGui(FrameBuffer const &frameBuffer) {
+        visible = ImGui::Begin("Game Viewport", NULL, ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoScrollWithMouse | ImGuiWindowFlags_MenuBar);
 
         if (imGuiSetup) {
             ImGui::SetWindowPos(ImVec2(800.0f, 500.0f));
@@ -71,7 +73,14 @@ namespace Dralgeer {
         rightX = leftX + windowSize.x;
         topY = bottomY + windowSize.y;
 
-        ImGui::Image((void*) frameBufferTexID, windowSize, ImVec2(0, 1), ImVec2(1, 0));
+        // the window's size is in screen coordinates which can differ from pixels on high DPI displays
+        ImVec2 fbScale = ImGui::GetIO().DisplayFramebufferScale;
+        viewWidth = (int) (windowSize.x * fbScale.x);
+        viewHeight = (int) (windowSize.y * fbScale.y);
+
+        // only show the region of the framebuffer that was rendered to
+        glm::vec2 maxUV = frameBuffer.getMaxUV();
+        ImGui::Image((void*) frameBuffer.getTextureID(), windowSize, ImVec2(0, maxUV.y), ImVec2(maxUV.x, 0));
 
         MouseListener::mGameViewPortX = bottomLeft.x;
         MouseListener::mGameViewPortY = bottomLeft.y;
@@ -84,6 +93,98 @@ namespace Dralgeer {
     #pragma GCC diagnostic pop
 
 
+    // * ======================================================
+    // * RenderStatsWindow Stuff
+
+    void RenderStatsWindow::imGui() {
+        ImGui::Begin("Render Stats");
+
+        if (imGuiSetup) {
+            // right of the Game Viewport
+            ImGui::SetWindowPos(ImVec2(1530.0f, 500.0f));
+            ImGui::SetWindowSize(ImVec2(340.0f, 520.0f));
+            imGuiSetup = 0;
+        }
+
+        RenderStats::FrameStats const &stats = Window::renderThread.getFrameStats();
+
+        ImGui::Text("Draw Calls: %d", stats.drawCalls);
+        ImGui::Text("Batch Draws: %d", stats.batchDraws);
+        ImGui::Text("Sprites Drawn: %d (%.1f per batch)", stats.spritesDrawn, stats.batchDraws ? (float) stats.spritesDrawn/stats.batchDraws : 0.0f);
+        ImGui::Text("Uploaded: %.1f KB", stats.bytesUploaded/1024.0f);
+        ImGui::Text("Texture Binds: %d", stats.textureBinds);
+
+        // * ------ History ------
+        // ? The graphs are scaled to the largest sample so a spike stands out against the frames around it.
+
+        int index;
+        RenderStats::FrameSample const* history = Window::renderThread.getHistory(index);
+
+        RenderStats::FrameSample peak = {0.0f, 0.0f, 0.0f};
+        for (int i = 0; i < RENDER_STATS_HISTORY; ++i) {
+            if (history[i].drawCalls > peak.drawCalls) { peak.drawCalls = history[i].drawCalls; }
+            if (history[i].uploadKB > peak.uploadKB) { peak.uploadKB = history[i].uploadKB; }
+            if (history[i].gpuTime > peak.gpuTime) { peak.gpuTime = history[i].gpuTime; }
+        }
+
+        char overlay[32];
+        ImVec2 graphSize(ImGui::GetContentRegionAvail().x, 40.0f);
+
+        ImGui::Separator();
+
+        std::snprintf(overlay, sizeof(overlay), "draws (peak %.0f)", peak.drawCalls);
+        ImGui::PlotLines("##DrawCalls", &history[0].drawCalls, RENDER_STATS_HISTORY, index, overlay, 0.0f, peak.drawCalls + 1.0f, graphSize,
+                sizeof(RenderStats::FrameSample));
+
+        std::snprintf(overlay, sizeof(overlay), "KB uploaded (peak %.1f)", peak.uploadKB);
+        ImGui::PlotLines("##Uploads", &history[0].uploadKB, RENDER_STATS_HISTORY, index, overlay, 0.0f, peak.uploadKB + 1.0f, graphSize,
+                sizeof(RenderStats::FrameSample));
+
+        std::snprintf(overlay, sizeof(overlay), "GPU ms (peak %.2f)", peak.gpuTime);
+        ImGui::PlotLines("##GPUTime", &history[0].gpuTime, RENDER_STATS_HISTORY, index, overlay, 0.0f, peak.gpuTime + 0.1f, graphSize,
+                sizeof(RenderStats::FrameSample));
+
+        // * ------ Layers ------
+
+        if (ImGui::CollapsingHeader("Layers") && ImGui::BeginTable("##Layers", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV)) {
+            ImGui::TableSetupColumn("zIndex");
+            ImGui::TableSetupColumn("Batches");
+            ImGui::TableSetupColumn("Sprites");
+            ImGui::TableSetupColumn("Per Batch");
+            ImGui::TableHeadersRow();
+
+            for (int i = 0; i < stats.numLayers; ++i) {
+                RenderStats::LayerStats const &l = stats.layers[i];
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::Text("%d", l.zIndex);
+                ImGui::TableNextColumn(); ImGui::Text("%d", l.batches);
+                ImGui::TableNextColumn(); ImGui::Text("%d", l.sprites);
+                ImGui::TableNextColumn(); ImGui::Text("%.1f", (float) l.sprites/l.batches);
+            }
+
+            ImGui::EndTable();
+        }
+
+        // * ------ VRAM ------
+
+        if (ImGui::CollapsingHeader("VRAM", ImGuiTreeNodeFlags_DefaultOpen)) {
+            static char const* categories[RenderStats::NUM_VRAM_CATEGORIES] = {"Buffers", "Textures", "Render Targets"};
+            long long total = 0;
+
+            for (int i = 0; i < RenderStats::NUM_VRAM_CATEGORIES; ++i) {
+                long long bytes = RenderStats::vram((RenderStats::VramCategory) i);
+                ImGui::Text("%s: %.2f MB", categories[i], bytes/(1024.0f*1024.0f));
+                total += bytes;
+            }
+
+            ImGui::Text("Total: %.2f MB", total/(1024.0f*1024.0f));
+        }
+
+        ImGui::End();
+    };
+
+
     // * ======================================================
     // * PropertiesWindow Stuff
 
@@ -141,6 +242,20 @@ namespace Dralgeer {
             }
 
             activeGameObject->imGui();
+
+            // y-sorting is set for the whole layer the object is on
+            int zIndex = activeGameObject->sprite->transform.zIndex;
+            bool ySort = Window::renderThread.isYSorted(zIndex);
+            if (ImGui::Checkbox("Y-Sort Layer", &ySort)) { Window::renderThread.setYSort(zIndex, ySort); }
+
+            // so is the layer's parallax
+            Parallax parallax = Window::renderThread.getParallax(zIndex);
+            DImGui::drawVec2Control("Scroll Factor", parallax.factor, 1.0f);
+            DImGui::drawVec2Control("Repeat", parallax.repeat);
+
+            Parallax const &old = Window::renderThread.getParallax(zIndex);
+            if (parallax.factor != old.factor || parallax.repeat != old.repeat) { Window::renderThread.setParallax(zIndex, parallax); }
+
             ImGui::End();
         }
     };
@@ -5,25 +5,44 @@ namespace Dralgeer {
     // * FrameBuffer Stuff
 
     void FrameBuffer::init(int width, int height) {
+        this->width = width;
+        this->height = height;
+
         // generate the framebuffer
-        glGenFramebuffers(1, &fboID);
-        glBindFramebuffer(GL_FRAMEBUFFER, fboID);
+        fboID = GPU::createFramebuffer();
 
         // create the texture to render the data to and attach it to our frame buffer
         tex.init(width, height);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tex.texID, 0);
+
+        // the texture is scaled up to the viewport when the render scale is below 1 so keep the pixels crisp
+        // clamp so the edge of the region rendered to never picks up texels from outside of it
+        GPU::textureSampling(tex.texID, GL_NEAREST, GL_CLAMP_TO_EDGE);
+        GPU::framebufferTexture(fboID, GL_COLOR_ATTACHMENT0, tex.texID);
         tex.unbind();
 
         // create the render buffer to store depth data
-        glGenRenderbuffers(1, &rboID);
-        glBindRenderbuffer(GL_RENDERBUFFER, rboID);
-        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
-        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, rboID);
-        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        rboID = GPU::createRenderbuffer();
+        GPU::renderbufferStorage(rboID, GL_DEPTH24_STENCIL8, width, height);
+        GPU::framebufferRenderbuffer(fboID, GL_DEPTH_STENCIL_ATTACHMENT, rboID);
 
         // ensure the framebuffer is complete
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) { throw std::runtime_error("[ERROR] Framebuffer is not complete.\n"); }
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (!GPU::isFramebufferComplete(fboID)) { throw std::runtime_error("[ERROR] Framebuffer is not complete.\n"); }
+    };
+
+    bool FrameBuffer::resize(int width, int height) {
+        this->width = width < 1 ? 1 : width;
+        this->height = height < 1 ? 1 : height;
+
+        if (this->width <= tex.width && this->height <= tex.height) { return 0; }
+
+        // grow to fit in both directions so a viewport being dragged back and forth does not reallocate every frame
+        if (this->width > tex.width) { tex.width = this->width; }
+        if (this->height > tex.height) { tex.height = this->height; }
+
+        // the IDs stay the same so the attachments of this framebuffer are kept
+        GPU::allocateTexture2D(tex.texID, GL_RGBA, tex.width, tex.height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+        GPU::renderbufferStorage(rboID, GL_DEPTH24_STENCIL8, tex.width, tex.height);
+        return 1;
     };
 
     // * =======================================================
@@ -34,39 +53,29 @@ namespace Dralgeer {
         this->height = height;
 
         // generate the framebuffer
-        glGenFramebuffers(1, &fboID);
-        glBindFramebuffer(GL_FRAMEBUFFER, fboID);
+        fboID = GPU::createFramebuffer();
 
-        // create the texture to render the data to and attach it to our frame buffer
-        glGenTextures(1, &pTexID);
-        glBindTexture(GL_TEXTURE_2D, pTexID);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, width, height, 0, GL_RGB, GL_FLOAT, 0);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, pTexID, 0);
+        // create the texture to render the data to and attach it to our frame buffer (it never changes size)
+        pTexID = GPU::createTexture2D();
+        GPU::textureSampling(pTexID, GL_NEAREST, GL_REPEAT);
+        GPU::storeTexture2D(pTexID, GL_RGB32F, 1, width, height, GL_RGB, GL_FLOAT, 0);
+        GPU::framebufferTexture(fboID, GL_COLOR_ATTACHMENT0, pTexID);
 
         // create the texture object for the depth buffer
-        glEnable(GL_DEPTH_TEST);
-        glGenTextures(1, &depthTexID);
-        glBindTexture(GL_TEXTURE_2D, depthTexID);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, 0);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexID, 0);
-        glDisable(GL_DEPTH_TEST);
+        depthTexID = GPU::createTexture2D();
+        GPU::storeTexture2D(depthTexID, GL_DEPTH_COMPONENT32F, 1, width, height, GL_DEPTH_COMPONENT, GL_FLOAT, 0);
+        GPU::framebufferTexture(fboID, GL_DEPTH_ATTACHMENT, depthTexID);
 
         // disable the reading
-        glReadBuffer(GL_NONE);
-        glDrawBuffer(GL_COLOR_ATTACHMENT0);
+        GPU::framebufferBuffers(fboID, GL_COLOR_ATTACHMENT0, GL_NONE);
 
         // ensure the frame buffer is complete
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        if (!GPU::isFramebufferComplete(fboID)) {
             throw std::runtime_error("[ERROR] Framebuffer was unable to be initialized.\n\tIt is not complete.\n");
         }
 
-        // unbind the texture and framebuffer
-        glBindTexture(GL_TEXTURE_2D, 0);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        // unbind the texture
+        GLState::bindTexture(GL_TEXTURE_2D, 0);
     };
 
     // * =======================================================
@@ -0,0 +1,215 @@
+#include <Dralgeer/framecapture.h>
+#include <STB/stb_image_write.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstring>
+#include <cstdio>
+#include <iostream>
+
+namespace Dralgeer {
+    namespace FrameCapture {
+        int every = 0;
+        std::string prefix = "capture";
+
+        namespace {
+            // A frame being copied into a pixel buffer.
+            struct Readback {
+                unsigned int pbo = 0;
+                int capacity = 0; // bytes the pixel buffer can hold
+                int width, height;
+                GLsync fence = 0; // signaled once the copy is done
+                std::string path;
+            };
+
+            // A frame waiting to be encoded.
+            struct Job {
+                unsigned char* pixels; // top row first
+                int width, height;
+                std::string path;
+            };
+
+            Readback ring[FRAME_CAPTURE_RING];
+            int head = 0; // oldest readback in flight (they finish in order)
+            int numInFlight = 0;
+
+            std::string single; // path to save the next frame to ("" = none)
+            long long frame = 0; // frames drawn since start
+
+            // * Encoder (the queue is shared with the worker thread).
+            std::thread worker;
+            std::mutex mutex;
+            std::condition_variable cv;
+            Job queue[FRAME_CAPTURE_MAX_QUEUED];
+            int queueHead = 0, queueSize = 0;
+            bool running = 0;
+
+            void encode() {
+                std::unique_lock<std::mutex> lock(mutex);
+
+                while(1) {
+                    cv.wait(lock, [] { return queueSize || !running; });
+                    if (!queueSize) { break; } // stopped and nothing is left to encode
+
+                    Job job = std::move(queue[queueHead]);
+                    queueHead = (queueHead + 1) % FRAME_CAPTURE_MAX_QUEUED;
+                    --queueSize;
+                    lock.unlock();
+
+                    if (stbi_write_png(job.path.c_str(), job.width, job.height, 4, job.pixels, 4*job.width)) {
+                        std::cout << "[INFO] Saved the frame capture " << job.path << ".\n";
+                    } else { std::cout << "[ERROR] Failed to write the frame capture " << job.path << ".\n"; }
+
+                    delete[] job.pixels;
+                    lock.lock();
+                }
+            };
+
+            // Read a finished copy out of its pixel buffer and hand it to the encoder.
+            void collect(Readback &r) {
+                glDeleteSync(r.fence);
+                r.fence = 0;
+
+                // only this thread adds to the queue so it cannot fill up between here and adding to it
+                bool full;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    full = queueSize == FRAME_CAPTURE_MAX_QUEUED;
+                }
+
+                if (full) {
+                    std::cout << "[WARNING] The frame capture encoder fell behind. Dropped " << r.path << ".\n";
+                    return;
+                }
+
+                int rowBytes = 4*r.width;
+                unsigned char* pixels = new unsigned char[rowBytes*r.height];
+
+                GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, r.pbo);
+                unsigned char const* mapped = (unsigned char const*) glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, rowBytes*r.height, GL_MAP_READ_BIT);
+
+                // GL's rows start from the bottom and PNG's start from the top
+                if (mapped) {
+                    for (int y = 0; y < r.height; ++y) { std::memcpy(&pixels[y*rowBytes], &mapped[(r.height - 1 - y)*rowBytes], rowBytes); }
+                    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+                }
+
+                GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+                if (!mapped) {
+                    std::cout << "[ERROR] Could not map the pixel buffer for the frame capture " << r.path << ".\n";
+                    delete[] pixels;
+                    return;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    queue[(queueHead + queueSize) % FRAME_CAPTURE_MAX_QUEUED] = {pixels, r.width, r.height, r.path};
+                    ++queueSize;
+                }
+
+                cv.notify_one();
+            };
+
+            inline void pop() {
+                collect(ring[head]);
+                head = (head + 1) % FRAME_CAPTURE_RING;
+                --numInFlight;
+            };
+        }
+
+        void start() {
+            running = 1;
+            worker = std::thread(encode);
+        };
+
+        void captureFrame(std::string const &path) { single = path; };
+
+        void update(FrameBuffer const &frameBuffer, bool newFrame) {
+            // * ------ Hand off the copies that have finished ------
+
+            while (numInFlight) {
+                GLenum status = glClientWaitSync(ring[head].fence, 0, 0); // only checks (never waits)
+                if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) { break; }
+                pop();
+            }
+
+            // * ------ Start copying the frame if it is due ------
+            // ? The framebuffer still holds the last frame drawn, so a single capture does not have to wait for a new one.
+
+            if (newFrame) { ++frame; }
+
+            bool recorded = newFrame && every > 0 && frame % every == 0;
+            if (single.empty() && !recorded) { return; }
+
+            // never wait on the GPU for a free pixel buffer (a single capture just tries again next frame)
+            if (numInFlight == FRAME_CAPTURE_RING) {
+                if (recorded) { std::cout << "[WARNING] Every frame capture buffer is busy. Skipped frame " << frame << ".\n"; }
+                return;
+            }
+
+            std::string path = single;
+            if (path.empty()) {
+                char name[32];
+                std::snprintf(name, sizeof(name), "_%06lld.png", frame);
+                path = prefix + name;
+            }
+
+            single.clear();
+
+            Readback &r = ring[(head + numInFlight) % FRAME_CAPTURE_RING];
+            int width = frameBuffer.getWidth(), height = frameBuffer.getHeight();
+            int bytes = 4*width*height;
+
+            if (!r.pbo) {
+                r.pbo = GPU::createBuffer(GL_PIXEL_PACK_BUFFER, bytes, NULL, GL_STREAM_READ);
+                r.capacity = bytes;
+
+            } else if (bytes > r.capacity) {
+                GPU::bufferData(GL_PIXEL_PACK_BUFFER, r.pbo, bytes, NULL, GL_STREAM_READ);
+                r.capacity = bytes;
+            }
+
+            // the copy lands in the pixel buffer instead of client memory so glReadPixels returns right away
+            GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, r.pbo);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, frameBuffer.getID());
+            glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+            GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, 0); // anything else reading pixels (like the picking texture) reads into client memory
+
+            r.width = width;
+            r.height = height;
+            r.path = path;
+            r.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            ++numInFlight;
+        };
+
+        void destroy() {
+            // finish the copies still in flight (the GPU has little left to do at shutdown so this is quick)
+            while (numInFlight) {
+                glClientWaitSync(ring[head].fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000); // 1 second
+                pop();
+            }
+
+            // the encoder finishes what is queued up before it stops
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                running = 0;
+            }
+
+            cv.notify_all();
+            if (worker.joinable()) { worker.join(); }
+
+            for (int i = 0; i < FRAME_CAPTURE_RING; ++i) {
+                if (!ring[i].pbo) { continue; }
+
+                GPU::deleteBuffers(1, &ring[i].pbo);
+                ring[i].pbo = 0;
+                ring[i].capacity = 0;
+            }
+
+            every = 0;
+            single.clear();
+        };
+    }
+}
@@ -0,0 +1,269 @@
+#include <iostream>
+#include <cstring>
+#include <Dralgeer/framegraph.h>
+
+namespace Dralgeer {
+    void FrameGraph::start() {
+        glGenQueries(RENDER_TIMER_QUERIES * FRAME_GRAPH_MAX_PASSES, &queries[0][0]);
+        started = 1;
+    };
+
+    int FrameGraph::import(char const* name, unsigned int fboID, unsigned int texID, int width, int height, bool consumed) {
+        FrameResource &r = resources[numResources];
+        r = FrameResource();
+        r.name = name;
+        r.fboID = fboID;
+        r.texID = texID;
+        r.width = width;
+        r.height = height;
+        r.imported = 1;
+        r.consumed = consumed;
+        return numResources++;
+    };
+
+    int FrameGraph::transient(char const* name, int width, int height, GLenum format) {
+        FrameResource &r = resources[numResources];
+        r = FrameResource();
+        r.name = name;
+        r.width = width < 1 ? 1 : width;
+        r.height = height < 1 ? 1 : height;
+        r.format = format;
+        r.imported = 0;
+        r.consumed = 0;
+        return numResources++;
+    };
+
+    FramePass& FrameGraph::addPass(char const* name, std::function<void()> execute) {
+        FramePass &p = passes[numPasses++];
+        p.name = name;
+        p.execute = std::move(execute);
+        p.numReads = 0;
+        p.numWrites = 0;
+        p.live = 0;
+        return p;
+    };
+
+    int FrameGraph::acquire(int width, int height, GLenum format) {
+        int spot = -1;
+
+        for (int i = 0; i < poolSize; ++i) {
+            PooledTarget const &t = pool[i];
+            if (!t.inUse && t.width == width && t.height == height && t.format == format) { spot = i; break; }
+        }
+
+        if (spot < 0) {
+            if (poolSize == FRAME_GRAPH_MAX_RESOURCES) {
+                if (!failed) { std::cout << "[ERROR] The frame graph ran out of transient targets.\n"; }
+                failed = 1;
+                return -1;
+            }
+
+            spot = poolSize++;
+            PooledTarget &t = pool[spot];
+            t.width = width;
+            t.height = height;
+            t.format = format;
+
+            // transient targets are read stretched over other targets so they are filtered linearly
+            t.texID = GPU::createTexture2D();
+            GPU::textureSampling(t.texID, GL_LINEAR, GL_CLAMP_TO_EDGE);
+            GPU::allocateTexture2D(t.texID, format, width, height, GL_RGBA, GL_FLOAT, 0);
+
+            t.fboID = GPU::createFramebuffer();
+            GPU::framebufferTexture(t.fboID, GL_COLOR_ATTACHMENT0, t.texID);
+
+            if (!GPU::isFramebufferComplete(t.fboID)) {
+                if (!failed) { std::cout << "[ERROR] Frame graph target is not complete.\n"; }
+                failed = 1;
+
+                glDeleteFramebuffers(1, &t.fboID);
+                GPU::deleteTextures(1, &t.texID);
+                --poolSize;
+                return -1;
+            }
+        }
+
+        pool[spot].inUse = 1;
+        pool[spot].lastUsed = frame;
+        return spot;
+    };
+
+    void FrameGraph::release(int resource) {
+        FrameResource &r = resources[resource];
+        if (r.imported || r.pooled < 0) { return; }
+
+        // later passes this frame can be handed the same target
+        pool[r.pooled].inUse = 0;
+        r.pooled = -1;
+    };
+
+    void FrameGraph::cull() {
+        for (int i = 0; i < numResources; ++i) { resources[i].needed = resources[i].imported && resources[i].consumed; }
+
+        // ? Walking backwards means every pass that reads a target is already known to be live or not when its writers are reached.
+        for (int i = numPasses - 1; i >= 0; --i) {
+            FramePass &p = passes[i];
+            p.live = 0;
+
+            for (int j = 0; j < p.numWrites; ++j) {
+                if (resources[p.writes[j]].needed) { p.live = 1; break; }
+            }
+
+            if (!p.live) { continue; }
+            for (int j = 0; j < p.numReads; ++j) { resources[p.reads[j]].needed = 1; }
+        }
+
+        // * ------ Merge the clears and find each target's lifetime ------
+
+        for (int i = 0; i < numPasses; ++i) {
+            FramePass const &p = passes[i];
+            if (!p.live) { continue; }
+
+            for (int j = 0; j < p.numWrites; ++j) {
+                FrameResource &r = resources[p.writes[j]];
+                if (r.firstWriter < 0) { r.firstWriter = i; }
+                r.lastUser = i;
+
+                // the first pass that asks for a color clear picks the color
+                if ((p.clearBits[j] & GL_COLOR_BUFFER_BIT) && !(r.clearBits & GL_COLOR_BUFFER_BIT)) {
+                    std::memcpy(r.clearColor, p.clearColors[j], sizeof(r.clearColor));
+                }
+
+                r.clearBits |= p.clearBits[j];
+            }
+
+            for (int j = 0; j < p.numReads; ++j) { resources[p.reads[j]].lastUser = i; }
+        }
+    };
+
+    void FrameGraph::readTimings(int slot) {
+        if (!numQueries[slot]) { return; }
+
+        // queries finish in order so the slot is done once its last query is
+        int available = 0;
+        glGetQueryObjectiv(queries[slot][numQueries[slot] - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) { return; }
+
+        numMeasured = numQueries[slot];
+        for (int i = 0; i < numMeasured; ++i) {
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(queries[slot][i], GL_QUERY_RESULT, &ns);
+
+            measured[i].name = queryNames[slot][i];
+            measured[i].gpuTime = ns * 1e-6f;
+            gpuTime += measured[i].gpuTime;
+        }
+    };
+
+    void FrameGraph::execute() {
+        // * ------ GPU Timing ------
+        // ? The queries from RENDER_TIMER_QUERIES frames ago are read (if they are done) right before their slot is reused.
+
+        int slot = frame % RENDER_TIMER_QUERIES;
+        gpuTime = 0.0f;
+        if (frame >= RENDER_TIMER_QUERIES) { readTimings(slot); }
+        numQueries[slot] = 0;
+
+        // * ------ Draw the live passes ------
+
+        cull();
+
+        for (int i = 0; i < numPasses; ++i) {
+            FramePass &p = passes[i];
+            if (!p.live) { continue; }
+
+            for (int j = 0; j < p.numWrites; ++j) {
+                FrameResource &r = resources[p.writes[j]];
+
+                if (!r.imported && r.pooled < 0) {
+                    r.pooled = acquire(r.width, r.height, r.format);
+                    if (r.pooled < 0) { p.live = 0; break; }
+
+                    r.fboID = pool[r.pooled].fboID;
+                    r.texID = pool[r.pooled].texID;
+                }
+            }
+
+            // a pass without a target to draw to is skipped (this runs on the render thread so throwing would end the program)
+            if (!p.live) {
+                for (int j = 0; j < p.numWrites; ++j) { release(p.writes[j]); }
+                continue;
+            }
+
+            // each target is cleared once right before the first pass that draws to it
+            // only the region being drawn to is cleared (the clear is limited by the scissor test)
+            glEnable(GL_SCISSOR_TEST);
+
+            for (int j = p.numWrites - 1; j >= 0; --j) {
+                FrameResource const &r = resources[p.writes[j]];
+
+                glBindFramebuffer(GL_FRAMEBUFFER, r.fboID);
+                glViewport(0, 0, r.width, r.height);
+                glScissor(0, 0, r.width, r.height);
+
+                if (r.firstWriter == i && r.clearBits) {
+                    glClearColor(r.clearColor[0], r.clearColor[1], r.clearColor[2], r.clearColor[3]);
+                    glClear(r.clearBits);
+                }
+            }
+
+            // the writes were walked backwards so the pass's first write is the one left bound
+            queryNames[slot][numQueries[slot]] = p.name;
+            glBeginQuery(GL_TIME_ELAPSED, queries[slot][numQueries[slot]++]);
+            p.execute();
+            glEndQuery(GL_TIME_ELAPSED);
+
+            for (int j = 0; j < p.numWrites; ++j) { if (resources[p.writes[j]].lastUser == i) { release(p.writes[j]); }}
+            for (int j = 0; j < p.numReads; ++j) { if (resources[p.reads[j]].lastUser == i) { release(p.reads[j]); }}
+        }
+
+        glDisable(GL_SCISSOR_TEST);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        // * ------ Free targets that have not been used in a while ------
+
+        for (int i = poolSize - 1; i >= 0; --i) {
+            if (pool[i].inUse || frame - pool[i].lastUsed < FRAME_GRAPH_TRANSIENT_LIFETIME) { continue; }
+
+            glDeleteFramebuffers(1, &pool[i].fboID);
+            GPU::deleteTextures(1, &pool[i].texID);
+            pool[i] = pool[--poolSize];
+        }
+
+        // * ------ Record the passes for the Debug menu ------
+
+        numTimings = numPasses;
+        for (int i = 0; i < numPasses; ++i) {
+            timings[i].name = passes[i].name;
+            timings[i].gpuTime = passes[i].live ? 0.0f : -1.0f;
+            if (!passes[i].live) { continue; }
+
+            for (int j = 0; j < numMeasured; ++j) {
+                if (!std::strcmp(measured[j].name, passes[i].name)) { timings[i].gpuTime = measured[j].gpuTime; break; }
+            }
+        }
+
+        // the passes' functions can hold onto the frame's data so let go of them now
+        for (int i = 0; i < numPasses; ++i) { passes[i].execute = nullptr; }
+
+        numPasses = 0;
+        numResources = 0;
+        ++frame;
+    };
+
+    void FrameGraph::stop() {
+        if (!started) { return; }
+
+        glDeleteQueries(RENDER_TIMER_QUERIES * FRAME_GRAPH_MAX_PASSES, &queries[0][0]);
+
+        for (int i = 0; i < poolSize; ++i) {
+            glDeleteFramebuffers(1, &pool[i].fboID);
+            GPU::deleteTextures(1, &pool[i].texID);
+        }
+
+        poolSize = 0;
+        numPasses = 0;
+        numResources = 0;
+        started = 0;
+    };
+}
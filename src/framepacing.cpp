@@ -0,0 +1,79 @@
+#include <Dralgeer/framepacing.h>
+#include <thread>
+#include <chrono>
+
+namespace Dralgeer {
+    namespace FramePacing {
+        PacingMode mode = PACING_VSYNC;
+        float targetFPS = FRAME_PACING_DEFAULT_FPS;
+        bool adaptiveSupported = 0;
+
+        FrameTiming history[FRAME_PACING_HISTORY] = {};
+        int index = 0;
+        int numFrames = 0;
+        double deadline = 0.0;
+
+        void init(PacingMode mode) {
+            adaptiveSupported = glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear");
+            for (int i = 0; i < FRAME_PACING_HISTORY; ++i) { history[i].inputLatency = -1.0f; }
+            setMode(mode);
+        };
+
+        void setMode(PacingMode mode) {
+            FramePacing::mode = mode;
+
+            switch(mode) {
+                case PACING_VSYNC: { glfwSwapInterval(1); break; }
+                case PACING_ADAPTIVE: { glfwSwapInterval(adaptiveSupported ? -1 : 1); break; }
+                case PACING_UNCAPPED: { glfwSwapInterval(0); break; }
+
+                case PACING_LIMITED: {
+                    glfwSwapInterval(0);
+                    deadline = glfwGetTime();
+                    break;
+                }
+            }
+        };
+
+        void limit() {
+            if (mode != PACING_LIMITED || targetFPS <= 0.0f) { return; }
+
+            // if the frame is already late (or the loop was idle) start counting from now instead of trying to catch up
+            double now = glfwGetTime();
+            double target = deadline + 1.0/targetFPS;
+            if (target < now) { target = now; }
+
+            // sleeping can overshoot by a scheduler tick so only sleep until close to the deadline and spin the rest of the way
+            while (target - now > FRAME_PACING_SPIN_TIME) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                now = glfwGetTime();
+            }
+
+            while (now < target) { now = glfwGetTime(); }
+            deadline = target;
+        };
+
+        FrameTiming average() {
+            FrameTiming avg = {0.0f, 0.0f, 0.0f, 0.0f};
+            int numInputs = 0;
+            if (!numFrames) { avg.inputLatency = -1.0f; return avg; }
+
+            for (int i = 0; i < numFrames; ++i) {
+                avg.frameTime += history[i].frameTime;
+                avg.cpuTime += history[i].cpuTime;
+                avg.presentTime += history[i].presentTime;
+
+                if (history[i].inputLatency >= 0.0f) {
+                    avg.inputLatency += history[i].inputLatency;
+                    ++numInputs;
+                }
+            }
+
+            avg.frameTime /= numFrames;
+            avg.cpuTime /= numFrames;
+            avg.presentTime /= numFrames;
+            avg.inputLatency = numInputs ? avg.inputLatency/numInputs : -1.0f;
+            return avg;
+        };
+    }
+}
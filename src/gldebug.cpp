@@ -0,0 +1,119 @@
+#include <Dralgeer/gldebug.h>
+
+#ifdef DRALGEER_GL_DEBUG
+
+#include <GLFW/glfw3.h>
+#include <iostream>
+#include <mutex>
+#include <map>
+#include <tuple>
+#include <string>
+
+namespace Dralgeer {
+    namespace GLDebug {
+        thread_local CallCounts counts;
+        thread_local CallCounts lastFrame;
+
+        namespace {
+            // * Live objects (made from both threads).
+            // ? VAO and framebuffer names are per context so their keys include the context. The rest are shared by every context.
+
+            typedef std::tuple<int, void*, GLuint> Key; // type, context, name
+
+            struct Site {
+                char const* file;
+                int line;
+            };
+
+            std::mutex mutex;
+            std::map<Key, Site> live;
+
+            thread_local bool khrDebug = 0; // the current context reports through the callback
+
+            char const* const objectNames[NUM_OBJECT_TYPES] = {"buffer", "texture", "VAO", "framebuffer", "renderbuffer"};
+
+            inline Key key(ObjectType type, GLuint id) {
+                bool perContext = type == OBJECT_VERTEX_ARRAY || type == OBJECT_FRAMEBUFFER;
+                return Key(type, perContext ? (void*) glfwGetCurrentContext() : nullptr, id);
+            };
+
+            void GLAPIENTRY onMessage(GLenum, GLenum type, GLuint id, GLenum severity, GLsizei, GLchar const* message, void const*) {
+                char const* level = severity == GL_DEBUG_SEVERITY_HIGH ? "high" : severity == GL_DEBUG_SEVERITY_MEDIUM ? "medium" : "low";
+                char const* kind = type == GL_DEBUG_TYPE_ERROR ? "Error" : type == GL_DEBUG_TYPE_PERFORMANCE ? "Performance" :
+                        type == GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR || type == GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR ? "Undefined" : "Info";
+
+                std::cout << "[GL " << kind << "] (" << level << ", " << id << ") " << message << "\n";
+            };
+        }
+
+        void init() {
+            khrDebug = GLEW_KHR_debug || GLEW_VERSION_4_3;
+
+            if (!khrDebug) {
+                std::cout << "[INFO] KHR_debug is not available. GL errors are only checked once per frame.\n";
+                return;
+            }
+
+            // synchronous so a message is printed while the call that caused it is still on the stack
+            glEnable(GL_DEBUG_OUTPUT);
+            glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+            glDebugMessageCallback(onMessage, nullptr);
+            glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+        };
+
+        void endFrame() {
+            if (!khrDebug) {
+                GLenum err;
+                while ((err = glGetError()) != GL_NO_ERROR) { std::cout << "[GL Error] 0x" << std::hex << err << std::dec << "\n"; }
+            }
+
+            lastFrame = counts;
+            counts = CallCounts();
+        };
+
+        void created(ObjectType type, GLsizei n, GLuint const* ids, char const* file, int line) {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (int i = 0; i < n; ++i) { live[key(type, ids[i])] = {file, line}; }
+        };
+
+        void deleted(ObjectType type, GLsizei n, GLuint const* ids) {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            for (int i = 0; i < n; ++i) {
+                if (!ids[i]) { continue; } // deleting 0 is allowed and does nothing
+
+                // deleting a name that is not alive is allowed by GL but almost always a double free
+                if (!live.erase(key(type, ids[i]))) { std::cout << "[GL Warning] Deleted a " << objectNames[type] << " (" << ids[i] << ") that is not alive.\n"; }
+            }
+        };
+
+        int liveCount(ObjectType type) {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            int n = 0;
+            for (auto const &obj : live) { if (std::get<0>(obj.first) == type) { ++n; }}
+            return n;
+        };
+
+        void report() {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (live.empty()) {
+                std::cout << "[INFO] No GL objects were leaked.\n";
+                return;
+            }
+
+            // group the leaks by type and where they were made
+            std::map<std::tuple<int, std::string, int>, int> groups;
+            for (auto const &obj : live) { ++groups[std::make_tuple(std::get<0>(obj.first), std::string(obj.second.file), obj.second.line)]; }
+
+            std::cout << "[INFO] " << live.size() << " GL objects are still alive at shutdown:\n";
+            for (auto const &g : groups) {
+                std::cout << "\t" << g.second << " " << objectNames[std::get<0>(g.first)] << (g.second > 1 ? "s" : "") << " made at " <<
+                        std::get<1>(g.first) << ":" << std::get<2>(g.first) << "\n";
+            }
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,7 @@
+#include <Dralgeer/glstate.h>
+
+namespace Dralgeer {
+    namespace GLState {
+        thread_local State state;
+    }
+}
@@ -0,0 +1,58 @@
+#include <Dralgeer/gpu.h>
+#include <iostream>
+
+namespace Dralgeer {
+    namespace GPU {
+        bool dsa = 0;
+
+        void init() {
+            dsa = GPU_ALLOW_DSA && (GLEW_VERSION_4_5 || GLEW_ARB_direct_state_access);
+            std::cout << "[INFO] GPU resources are edited " << (dsa ? "with direct state access.\n" : "by binding them (GL 3.3).\n");
+        };
+
+        unsigned int createVertexArray(unsigned int vbo, unsigned int ebo, int stride, VertexAttribute const* attributes, int numAttributes) {
+            unsigned int id;
+
+            if (dsa) {
+                glCreateVertexArrays(1, &id);
+                glVertexArrayVertexBuffer(id, 0, vbo, 0, stride);
+                if (ebo) { glVertexArrayElementBuffer(id, ebo); }
+
+                for (int i = 0; i < numAttributes; ++i) {
+                    glEnableVertexArrayAttrib(id, i);
+                    glVertexArrayAttribFormat(id, i, attributes[i].size, GL_FLOAT, 0, attributes[i].offset);
+                    glVertexArrayAttribBinding(id, i, 0);
+                }
+
+                return id;
+            }
+
+            glGenVertexArrays(1, &id);
+            GLState::bindVertexArray(id);
+            GLState::bindBuffer(GL_ARRAY_BUFFER, vbo);
+            if (ebo) { glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo); }
+
+            for (int i = 0; i < numAttributes; ++i) {
+                glVertexAttribPointer(i, attributes[i].size, GL_FLOAT, 0, stride, (void*) (intptr_t) attributes[i].offset);
+                glEnableVertexAttribArray(i);
+            }
+
+            return id;
+        };
+
+        void storeTexture2D(unsigned int id, GLenum sizedFormat, int levels, int width, int height, GLenum format, GLenum type, void const* data) {
+            RenderStats::setTextureSize(id, RenderStats::textureBytes(sizedFormat, width, height, levels));
+            if (data) { RenderStats::uploaded((long long) RenderStats::pixelBytes(format, type) * width * height); }
+
+            if (dsa) {
+                glTextureStorage2D(id, levels, sizedFormat, width, height);
+                if (data) { glTextureSubImage2D(id, 0, 0, 0, width, height, format, type, data); }
+                return;
+            }
+
+            // the fallback's storage is mutable, so the other levels are left for glGenerateMipmap
+            GLState::bindTexture(GL_TEXTURE_2D, id);
+            glTexImage2D(GL_TEXTURE_2D, 0, sizedFormat, width, height, 0, format, type, data);
+        };
+    }
+}
@@ -1,6 +1,9 @@
 #include <Dralgeer/window.h>
 #include <Dralgeer/listeners.h>
 #include <Dralgeer/imguilayer.h>
+#include <Dralgeer/physicsdebug.h>
+#include <Dralgeer/renderscale.h>
+#include <Dralgeer/framepacing.h>
 
 namespace Dralgeer {
     inline void ImGuiLayer::setupDockerSpace(int width, int height) const {
@@ -70,7 +73,7 @@ namespace Dralgeer {
 
     // todo alternatively could make separate overloaded functions for the different scene classes
     // ! for now will do it like this though
-    void ImGuiLayer::update(float dt, void* currScene, ROOT_SCENE sceneType, unsigned int frameBufferTexID, int windowWidth, int windowHeight) {
+    void ImGuiLayer::update(float dt, void* currScene, ROOT_SCENE sceneType, FrameBuffer const &frameBuffer, int windowWidth, int windowHeight) {
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
@@ -81,7 +84,8 @@ namespace Dralgeer {
             case LEVEL_EDITOR_SCENE: { ((LevelEditorScene*) currScene)->imGui(); break; }
         }
 
-        gameViewWindow.imGui(frameBufferTexID);
+        gameViewWindow.imGui(frameBuffer);
+        renderStatsWindow.imGui();
         propertiesWindow.update(dt, currScene, sceneType, gameViewWindow.getWantCaptureMouse());
         propertiesWindow.imGui();
 
@@ -102,6 +106,114 @@ namespace Dralgeer {
             ImGui::EndMenu();
         }
 
+        if (ImGui::BeginMenu("Debug")) {
+            ImGui::MenuItem("Physics Overlay", NULL, &PhysicsDebug::enabled);
+
+            // only let the user pick what to show while the overlay is on
+            ImGui::BeginDisabled(!PhysicsDebug::enabled);
+            ImGui::MenuItem("Colliders", NULL, &PhysicsDebug::showColliders);
+            ImGui::MenuItem("Contacts", NULL, &PhysicsDebug::showContacts);
+            ImGui::MenuItem("Bounds", NULL, &PhysicsDebug::showBounds);
+            ImGui::EndDisabled();
+
+            // binds the render thread made (and skipped thanks to the state cache) last frame
+            GLState::Counters const &stats = Window::renderThread.getStats();
+
+            ImGui::Separator();
+            ImGui::Text("Program Binds: %d (%d skipped)", stats.programBinds, stats.programSkips);
+            ImGui::Text("VAO Binds: %d (%d skipped)", stats.vaoBinds, stats.vaoSkips);
+            ImGui::Text("Texture Binds: %d (%d skipped)", stats.textureBinds, stats.textureSkips);
+            ImGui::Text("Buffer Binds: %d (%d skipped)", stats.bufferBinds, stats.bufferSkips);
+
+            #ifdef DRALGEER_GL_DEBUG
+                // every traced GL call the render thread made last frame
+                GLDebug::CallCounts const &calls = Window::renderThread.getCalls();
+
+                ImGui::Separator();
+                ImGui::Text("GL Draws: %d", calls.calls[GLDebug::CALL_DRAW]);
+                ImGui::Text("GL Uploads: %d", calls.calls[GLDebug::CALL_UPLOAD]);
+                ImGui::Text("GL Binds: %d", calls.calls[GLDebug::CALL_BIND]);
+                ImGui::Text("GL Objects Made/Deleted: %d/%d", calls.calls[GLDebug::CALL_CREATE], calls.calls[GLDebug::CALL_DELETE]);
+                ImGui::Text("Live Textures: %d", GLDebug::liveCount(GLDebug::OBJECT_TEXTURE));
+                ImGui::Text("Live Buffers: %d", GLDebug::liveCount(GLDebug::OBJECT_BUFFER));
+            #endif
+
+            ImGui::Separator();
+            ImGui::MenuItem("Idle When Inactive", NULL, &Window::idleEnabled);
+            if (ImGui::MenuItem("Lighting", NULL, &Lighting::enabled)) { Lighting::dirty = 1; }
+            if (ImGui::MenuItem("Fog of War", NULL, &Discovery::enabled)) { Discovery::changed = 1; }
+            ImGui::MenuItem("Dynamic Resolution", NULL, &RenderScale::enabled);
+
+            // the scale can only be set by hand while the controller is off
+            ImGui::BeginDisabled(RenderScale::enabled);
+            ImGui::SliderFloat("Render Scale", &RenderScale::scale, RENDER_SCALE_MIN, RENDER_SCALE_MAX, "%.2f");
+            ImGui::EndDisabled();
+
+            ImGui::Text("Scene GPU Time: %.2f ms", RenderScale::gpuTime);
+
+            // the render thread's passes (ones nothing read last frame were culled)
+            int numPasses;
+            PassTiming const* passes = Window::renderThread.getPassTimings(numPasses);
+
+            for (int i = 0; i < numPasses; ++i) {
+                if (passes[i].gpuTime < 0.0f) { ImGui::TextDisabled("  %s: (culled)", passes[i].name); }
+                else { ImGui::Text("  %s: %.2f ms", passes[i].name, passes[i].gpuTime); }
+            }
+
+            ImGui::Text("Render Size: %dx%d", Window::frameBuffer.getWidth(), Window::frameBuffer.getHeight());
+
+            // * ------ Frame Capture ------
+
+            ImGui::Separator();
+
+            if (ImGui::MenuItem("Capture Frame")) {
+                static int numCaptures = 0;
+                FrameCapture::captureFrame("frame_" + std::to_string(numCaptures++) + ".png");
+            }
+
+            static int captureEvery = 1;
+            bool recording = FrameCapture::isRecording();
+
+            if (ImGui::MenuItem("Record Frames", NULL, recording)) {
+                if (recording) { FrameCapture::stopRecording(); }
+                else { FrameCapture::startRecording(captureEvery, "recording"); }
+            }
+
+            ImGui::BeginDisabled(recording);
+            ImGui::SliderInt("Every N Frames", &captureEvery, 1, 60);
+            ImGui::EndDisabled();
+
+            // * ------ Frame Pacing ------
+
+            ImGui::Separator();
+
+            static char const* pacingModes[4] = {"V-Sync", "Adaptive V-Sync", "Uncapped", "Frame Limiter"};
+            int pacingMode = FramePacing::mode;
+
+            if (ImGui::Combo("Frame Pacing", &pacingMode, pacingModes, 4)) { FramePacing::setMode((PacingMode) pacingMode); }
+            if (FramePacing::mode == PACING_ADAPTIVE && !FramePacing::adaptiveSupported) { ImGui::TextDisabled("Adaptive v-sync is not supported (using v-sync)"); }
+
+            ImGui::BeginDisabled(FramePacing::mode != PACING_LIMITED);
+            ImGui::SliderFloat("Target FPS", &FramePacing::targetFPS, 30.0f, 360.0f, "%.0f");
+            ImGui::EndDisabled();
+
+            FramePacing::FrameTiming const &latest = FramePacing::latest();
+            FramePacing::FrameTiming avg = FramePacing::average();
+
+            ImGui::Text("Frame Time: %.2f ms (avg %.2f)", latest.frameTime, avg.frameTime);
+            ImGui::Text("CPU Time: %.2f ms (avg %.2f)", latest.cpuTime, avg.cpuTime);
+            ImGui::Text("Present Time: %.2f ms (avg %.2f)", latest.presentTime, avg.presentTime);
+
+            if (avg.inputLatency >= 0.0f) { ImGui::Text("Input to Present: %.2f ms (avg)", avg.inputLatency); }
+            else { ImGui::TextDisabled("Input to Present: no input"); }
+
+            // frame times with the oldest on the left
+            ImGui::PlotLines("##FrameTimes", &FramePacing::history[0].frameTime, FRAME_PACING_HISTORY, FramePacing::index, NULL, 0.0f,
+                    50.0f, ImVec2(DEFAULT_WIDGET_WIDTH, 40.0f), sizeof(FramePacing::FrameTiming));
+
+            ImGui::EndMenu();
+        }
+
         ImGui::EndMainMenuBar();
 
         // * ---------------------------------
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <Dralgeer/lighting.h>
+
+namespace Dralgeer {
+    namespace Lighting {
+        PointLight* lights = new PointLight[LIGHT_START_CAPACITY];
+        int numLights = 0;
+        int capacity = LIGHT_START_CAPACITY;
+
+        bool enabled = 0;
+        glm::vec3 ambient(1.0f, 1.0f, 1.0f);
+        bool dirty = 0;
+
+        unsigned int lightMap = 0;
+        int sceneWidth = 0, sceneHeight = 0;
+        bool started = 0, active = 0;
+
+        namespace {
+            Shader* shader = nullptr;
+            unsigned int vaoID, vboID;
+
+            // * Texture buffers read by the light pass.
+            unsigned int tileBuffer, tileTex; // offset and count into the index list for each tile
+            unsigned int indexBuffer, indexTex; // light indices for each tile, back to back
+            unsigned int lightBuffer, lightTex; // 2 texels per light -- (x, y, radius, intensity), (r, g, b, unused)
+
+            // * CPU side of the texture buffers (kept around between frames).
+            int* tiles = nullptr; // pairs of offset and count
+            int tileCapacity = 0;
+
+            int* indices = nullptr;
+            int indexCapacity = 0;
+
+            float* lightData = nullptr;
+            int* lightRects = nullptr; // tile range each light covers (x0, y0, x1, y1) or -1s if it is off screen
+            int lightCapacity = 0;
+
+            // Make sure a texture buffer can hold size bytes and upload data into it.
+            // The storage is orphaned every frame so uploading never waits on the last frame's light pass.
+            inline void upload(unsigned int buffer, void const* data, int size) {
+                GLState::bindBuffer(GL_TEXTURE_BUFFER, buffer);
+                glBufferData(GL_TEXTURE_BUFFER, size > 0 ? size : 16, NULL, GL_STREAM_DRAW);
+                if (size > 0) {
+                    glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data);
+                    RenderStats::uploaded(size);
+                }
+            };
+
+            inline void makeTextureBuffer(unsigned int &buffer, unsigned int &tex, GLenum format) {
+                glGenBuffers(1, &buffer);
+                GLState::bindBuffer(GL_TEXTURE_BUFFER, buffer);
+                glBufferData(GL_TEXTURE_BUFFER, 16, NULL, GL_STREAM_DRAW);
+
+                glGenTextures(1, &tex);
+                GLState::bindTexture(GL_TEXTURE_BUFFER, tex);
+                glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
+            };
+        }
+
+        void start(Shader* lightingShader) {
+            shader = lightingShader;
+
+            // full viewport quad in normalized device coordinates
+            float vertices[8] = {1.0f, 1.0f, 1.0f, -1.0f, -1.0f, 1.0f, -1.0f, -1.0f};
+
+            glGenVertexArrays(1, &vaoID);
+            GLState::bindVertexArray(vaoID);
+
+            glGenBuffers(1, &vboID);
+            GLState::bindBuffer(GL_ARRAY_BUFFER, vboID);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+            glVertexAttribPointer(0, 2, GL_FLOAT, 0, 2 * sizeof(float), (void*) 0);
+            glEnableVertexAttribArray(0);
+
+            makeTextureBuffer(tileBuffer, tileTex, GL_RG32I);
+            makeTextureBuffer(indexBuffer, indexTex, GL_R32I);
+            makeTextureBuffer(lightBuffer, lightTex, GL_RGBA32F);
+
+            started = 1;
+        };
+
+        void render(PointLight const* lights, int numLights, glm::vec3 const &ambient, Camera const &cam, int sceneWidth, int sceneHeight,
+                unsigned int mapTexID, int mapWidth, int mapHeight) {
+            Lighting::sceneWidth = sceneWidth;
+            Lighting::sceneHeight = sceneHeight;
+            lightMap = mapTexID;
+
+            int tilesX = (mapWidth + LIGHT_TILE_SIZE - 1)/LIGHT_TILE_SIZE;
+            int tilesY = (mapHeight + LIGHT_TILE_SIZE - 1)/LIGHT_TILE_SIZE;
+            int numTiles = tilesX * tilesY;
+
+            // * ------ Grow the CPU stores ------
+
+            if (numTiles > tileCapacity) {
+                while (tileCapacity < numTiles) { tileCapacity = tileCapacity ? 2*tileCapacity : 64; }
+                delete[] tiles;
+                tiles = new int[2 * tileCapacity];
+            }
+
+            if (numLights > lightCapacity) {
+                while (lightCapacity < numLights) { lightCapacity = lightCapacity ? 2*lightCapacity : LIGHT_START_CAPACITY; }
+                delete[] lightData;
+                delete[] lightRects;
+                lightData = new float[8 * lightCapacity];
+                lightRects = new int[4 * lightCapacity];
+            }
+
+            // * ------ Cull the lights into tiles ------
+            // ? The projection is orthographic so the corners of a light's bounding box map straight to the tiles it covers.
+
+            glm::mat4 viewProj = cam.proj * cam.view;
+            std::memset(tiles, 0, 2 * numTiles * sizeof(int));
+            int totalIndices = 0;
+
+            for (int i = 0; i < numLights; ++i) {
+                PointLight const &light = lights[i];
+                int* rect = &lightRects[4*i];
+
+                float* data = &lightData[8*i];
+                data[0] = light.pos.x;
+                data[1] = light.pos.y;
+                data[2] = light.radius;
+                data[3] = light.intensity;
+                data[4] = light.color.x;
+                data[5] = light.color.y;
+                data[6] = light.color.z;
+                data[7] = 0.0f;
+
+                glm::vec4 a = viewProj * glm::vec4(light.pos - light.radius, 0.0f, 1.0f);
+                glm::vec4 b = viewProj * glm::vec4(light.pos + light.radius, 0.0f, 1.0f);
+
+                // normalized device coordinates -> light map pixels
+                float x0 = (0.5f*std::min(a.x, b.x) + 0.5f) * mapWidth, x1 = (0.5f*std::max(a.x, b.x) + 0.5f) * mapWidth;
+                float y0 = (0.5f*std::min(a.y, b.y) + 0.5f) * mapHeight, y1 = (0.5f*std::max(a.y, b.y) + 0.5f) * mapHeight;
+
+                if (light.radius <= 0.0f || x1 < 0.0f || y1 < 0.0f || x0 >= mapWidth || y0 >= mapHeight) {
+                    rect[0] = -1;
+                    continue;
+                }
+
+                rect[0] = std::max((int) x0, 0)/LIGHT_TILE_SIZE;
+                rect[1] = std::max((int) y0, 0)/LIGHT_TILE_SIZE;
+                rect[2] = std::min((int) x1/LIGHT_TILE_SIZE, tilesX - 1);
+                rect[3] = std::min((int) y1/LIGHT_TILE_SIZE, tilesY - 1);
+
+                for (int y = rect[1]; y <= rect[3]; ++y) {
+                    for (int x = rect[0]; x <= rect[2]; ++x) { ++tiles[2*(y*tilesX + x) + 1]; }
+                }
+
+                totalIndices += (rect[2] - rect[0] + 1) * (rect[3] - rect[1] + 1);
+            }
+
+            if (totalIndices > indexCapacity) {
+                while (indexCapacity < totalIndices) { indexCapacity = indexCapacity ? 2*indexCapacity : 256; }
+                delete[] indices;
+                indices = new int[indexCapacity];
+            }
+
+            // each tile's list starts where the last one ended
+            // the counts are rebuilt while filling in the lists
+            for (int t = 0, offset = 0; t < numTiles; ++t) {
+                tiles[2*t] = offset;
+                offset += tiles[2*t + 1];
+                tiles[2*t + 1] = 0;
+            }
+
+            for (int i = 0; i < numLights; ++i) {
+                int const* rect = &lightRects[4*i];
+                if (rect[0] < 0) { continue; }
+
+                for (int y = rect[1]; y <= rect[3]; ++y) {
+                    for (int x = rect[0]; x <= rect[2]; ++x) {
+                        int* tile = &tiles[2*(y*tilesX + x)];
+                        indices[tile[0] + tile[1]++] = i;
+                    }
+                }
+            }
+
+            // * ------ Upload and draw ------
+
+            upload(tileBuffer, tiles, 2 * numTiles * sizeof(int));
+            upload(indexBuffer, indices, totalIndices * sizeof(int));
+            upload(lightBuffer, lightData, 8 * numLights * sizeof(float));
+
+            glDisable(GL_BLEND); // every pixel is written exactly once
+
+            shader->use();
+            GLState::bindTexture(LIGHT_TILES_TEX_SLOT, GL_TEXTURE_BUFFER, tileTex);
+            GLState::bindTexture(LIGHT_INDICES_TEX_SLOT, GL_TEXTURE_BUFFER, indexTex);
+            GLState::bindTexture(LIGHT_DATA_TEX_SLOT, GL_TEXTURE_BUFFER, lightTex);
+
+            shader->uploadInt("uTiles", LIGHT_TILES_TEX_SLOT);
+            shader->uploadInt("uIndices", LIGHT_INDICES_TEX_SLOT);
+            shader->uploadInt("uLights", LIGHT_DATA_TEX_SLOT);
+            shader->uploadInt("uTilesX", tilesX);
+            shader->uploadInt("uTileSize", LIGHT_TILE_SIZE);
+            shader->uploadVec3("uAmbient", ambient);
+
+            GLState::bindVertexArray(vaoID);
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+            RenderStats::countDraw();
+
+            glEnable(GL_BLEND);
+            active = 1;
+        };
+
+        void stop() {
+            if (!started) { return; }
+
+            unsigned int buffers[4] = {vboID, tileBuffer, indexBuffer, lightBuffer};
+            unsigned int textures[3] = {tileTex, indexTex, lightTex};
+
+            glDeleteVertexArrays(1, &vaoID);
+            glDeleteBuffers(4, buffers);
+            glDeleteTextures(3, textures);
+
+            GLState::forgetVertexArray(vaoID);
+            for (int i = 0; i < 4; ++i) { GLState::forgetBuffer(buffers[i]); }
+            for (int i = 0; i < 3; ++i) { GLState::forgetTexture(textures[i]); }
+
+            delete[] tiles;
+            delete[] indices;
+            delete[] lightData;
+            delete[] lightRects;
+
+            tiles = nullptr;
+            indices = nullptr;
+            lightData = nullptr;
+            lightRects = nullptr;
+            tileCapacity = indexCapacity = lightCapacity = 0;
+            lightMap = 0;
+
+            started = 0;
+            active = 0;
+        };
+    }
+}
@@ -1,6 +1,11 @@
 #include <Dralgeer/listeners.h>
 
 namespace Dralgeer {
+    namespace InputListener {
+        bool received = 0;
+        double inputTime = 0.0;
+    }
+
     namespace MouseListener {
         float mScrollX = 0, mScrollY = 0;
         float mX = 0, mY = 0, mLastX = 0, mLastY = 0;
@@ -16,6 +21,7 @@ namespace Dralgeer {
 
     namespace KeyListener {
         bool keyPressed[350] = {0};
+        int keysDown = 0;
     }
 
     namespace JoystickListener {
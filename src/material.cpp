@@ -0,0 +1,59 @@
+#include <Dralgeer/material.h>
+
+namespace Dralgeer {
+    namespace Materials {
+        Material* materials = new Material[MATERIAL_START_CAPACITY]; // entry 0 is already the default material
+        int numMaterials = 1;
+        int capacity = MATERIAL_START_CAPACITY;
+
+        Texture* palette = nullptr;
+
+        unsigned int tableBuffer, tableTex;
+        int bufferCapacity = 0;
+        int dirtyMin = 0, dirtyMax = 0;
+        bool started = 0;
+
+        bool update() {
+            if (!started || dirtyMin > dirtyMax) { return 0; }
+
+            // the buffer has to be remade once the table outgrows it (and then everything is uploaded)
+            GLState::bindBuffer(GL_TEXTURE_BUFFER, tableBuffer);
+
+            if (bufferCapacity < capacity) {
+                glBufferData(GL_TEXTURE_BUFFER, capacity * MATERIAL_SIZE_BYTES, NULL, GL_DYNAMIC_DRAW);
+                bufferCapacity = capacity;
+                dirtyMin = 0;
+                dirtyMax = numMaterials - 1;
+            }
+
+            int count = dirtyMax - dirtyMin + 1;
+            float* data = new float[count * MATERIAL_SIZE];
+
+            for (int i = 0; i < count; ++i) {
+                Material const &m = materials[dirtyMin + i];
+                float* d = &data[i * MATERIAL_SIZE];
+
+                d[0] = m.tint.x;
+                d[1] = m.tint.y;
+                d[2] = m.tint.z;
+                d[3] = m.tint.w;
+                d[4] = m.flashColor.x;
+                d[5] = m.flashColor.y;
+                d[6] = m.flashColor.z;
+                d[7] = m.flash;
+                d[8] = m.paletteRow;
+                d[9] = m.blend;
+                d[10] = 0.0f;
+                d[11] = 0.0f;
+            }
+
+            glBufferSubData(GL_TEXTURE_BUFFER, dirtyMin * MATERIAL_SIZE_BYTES, count * MATERIAL_SIZE_BYTES, data);
+            RenderStats::uploaded(count * MATERIAL_SIZE_BYTES);
+
+            delete[] data;
+            dirtyMin = numMaterials;
+            dirtyMax = -1;
+            return 1;
+        };
+    }
+}
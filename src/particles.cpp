@@ -0,0 +1,404 @@
+#include <Dralgeer/particles.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define DRALGEER_PARTICLES_SSE
+#endif
+
+namespace Dralgeer {
+    namespace Particles {
+        ParticleEmitter** emitters = new ParticleEmitter*[PARTICLE_START_EMITTERS];
+        int numEmitters = 0;
+        int capacity = PARTICLE_START_EMITTERS;
+
+        Shader* shader = nullptr;
+        unsigned int vaoID, quadID;
+        bool started = 0;
+
+        namespace {
+            // * Packed buffers (one per group of emitters drawn together).
+            // ? They are only filled between frames and never freed until destroy() so the render thread can always draw from them.
+
+            struct PackedBuffer {
+                unsigned int vboID;
+                int capacity; // particles it has room for
+            };
+
+            PackedBuffer* buffers = nullptr;
+            int numBuffers = 0;
+            int bufferCapacity = 0;
+
+            ParticleDraw* groups = nullptr; // what the last upload packed (has room for orderCapacity groups)
+            int numGroups = 0;
+
+            // * Parameter table (3 texels per emitter -- start color, end color, start and end size).
+            unsigned int paramBuffer = 0, paramTex = 0;
+            int paramCapacity = 0; // emitters the table has room for
+
+            // * Reused by every upload.
+            ParticleEmitter** order = nullptr; // live emitters sorted into their groups
+            int orderCapacity = 0;
+            float* emitterIDs = nullptr; // each particle's entry in the parameter table
+            int emitterIDCapacity = 0;
+
+            inline unsigned int textureOf(ParticleEmitter const* e) { return e->texture ? e->texture->texID : 0; };
+
+            inline bool sameGroup(ParticleEmitter const* a, ParticleEmitter const* b) {
+                return textureOf(a) == textureOf(b) && a->additive == b->additive;
+            };
+        }
+    }
+
+    // * ====================================================
+    // * ParticleEmitter Stuff
+
+    ParticleEmitter::~ParticleEmitter() {
+        delete[] posX;
+        delete[] posY;
+        delete[] velX;
+        delete[] velY;
+        delete[] life;
+        delete[] lifetime;
+    };
+
+    void ParticleEmitter::init(int capacity) {
+        this->capacity = capacity;
+        numAlive = 0;
+
+        posX = new float[capacity];
+        posY = new float[capacity];
+        velX = new float[capacity];
+        velY = new float[capacity];
+        life = new float[capacity];
+        lifetime = new float[capacity];
+    };
+
+    void ParticleEmitter::spawn(int count) {
+        if (count > capacity - numAlive) { count = capacity - numAlive; }
+
+        for (int i = numAlive; i < numAlive + count; ++i) {
+            float angle = glm::radians(direction + random(-0.5f, 0.5f) * spread);
+            float speed = random(minSpeed, maxSpeed);
+
+            posX[i] = pos.x;
+            posY[i] = pos.y;
+            velX[i] = std::cos(angle) * speed;
+            velY[i] = std::sin(angle) * speed;
+            life[i] = lifetime[i] = random(minLifetime, maxLifetime);
+        }
+
+        numAlive += count;
+    };
+
+    void ParticleEmitter::update(float dt) {
+        // * ------ Spawn ------
+
+        spawnDebt += rate * dt;
+        int count = (int) spawnDebt;
+        spawnDebt -= count;
+        if (count) { spawn(count); }
+
+        // * ------ Integrate ------
+
+        float damping = drag > 0.0f ? std::fmax(1.0f - drag * dt, 0.0f) : 1.0f;
+        float gx = gravity.x * dt, gy = gravity.y * dt;
+        int i = 0;
+
+        #ifdef DRALGEER_PARTICLES_SSE
+            __m128 vdt = _mm_set1_ps(dt);
+            __m128 vdamp = _mm_set1_ps(damping);
+            __m128 vgx = _mm_set1_ps(gx), vgy = _mm_set1_ps(gy);
+
+            for (; i + 4 <= numAlive; i += 4) {
+                __m128 vx = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&velX[i]), vdamp), vgx);
+                __m128 vy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&velY[i]), vdamp), vgy);
+
+                _mm_storeu_ps(&velX[i], vx);
+                _mm_storeu_ps(&velY[i], vy);
+                _mm_storeu_ps(&posX[i], _mm_add_ps(_mm_loadu_ps(&posX[i]), _mm_mul_ps(vx, vdt)));
+                _mm_storeu_ps(&posY[i], _mm_add_ps(_mm_loadu_ps(&posY[i]), _mm_mul_ps(vy, vdt)));
+                _mm_storeu_ps(&life[i], _mm_sub_ps(_mm_loadu_ps(&life[i]), vdt));
+            }
+        #endif
+
+        // whatever did not fill a full SIMD lane (or everything without SSE)
+        for (; i < numAlive; ++i) {
+            velX[i] = velX[i] * damping + gx;
+            velY[i] = velY[i] * damping + gy;
+            posX[i] += velX[i] * dt;
+            posY[i] += velY[i] * dt;
+            life[i] -= dt;
+        }
+
+        // * ------ Recycle ------
+        // ? Order does not matter so the last live particle is moved into each dead slot.
+
+        for (i = numAlive - 1; i >= 0; --i) {
+            if (life[i] > 0.0f) { continue; }
+
+            --numAlive;
+            posX[i] = posX[numAlive];
+            posY[i] = posY[numAlive];
+            velX[i] = velX[numAlive];
+            velY[i] = velY[numAlive];
+            life[i] = life[numAlive];
+            lifetime[i] = lifetime[numAlive];
+        }
+    };
+
+    // * ====================================================
+    // * Particles Stuff
+
+    namespace Particles {
+        void add(ParticleEmitter* emitter) {
+            if (numEmitters == capacity) {
+                capacity = capacity ? 2*capacity : PARTICLE_START_EMITTERS; // destroy() leaves it at 0
+                ParticleEmitter** temp = new ParticleEmitter*[capacity];
+                for (int i = 0; i < numEmitters; ++i) { temp[i] = emitters[i]; }
+
+                delete[] emitters;
+                emitters = temp;
+            }
+
+            emitters[numEmitters++] = emitter;
+        };
+
+        void remove(ParticleEmitter* emitter) {
+            for (int i = 0; i < numEmitters; ++i) {
+                if (emitters[i] == emitter) {
+                    emitters[i] = emitters[--numEmitters];
+                    delete emitter;
+                    return;
+                }
+            }
+        };
+
+        void upload() {
+            // * ------ Sort the live emitters into groups ------
+
+            if (numEmitters > orderCapacity) {
+                while (orderCapacity < numEmitters) { orderCapacity = orderCapacity ? 2*orderCapacity : PARTICLE_START_EMITTERS; }
+
+                delete[] order;
+                delete[] groups;
+                order = new ParticleEmitter*[orderCapacity];
+                groups = new ParticleDraw[orderCapacity];
+            }
+
+            int numLive = 0;
+            for (int i = 0; i < numEmitters; ++i) { if (emitters[i]->numAlive) { order[numLive++] = emitters[i]; }}
+
+            // stable so the emitters in a group keep the order they were added in
+            std::stable_sort(order, order + numLive, [](ParticleEmitter const* a, ParticleEmitter const* b) {
+                unsigned int ta = textureOf(a), tb = textureOf(b);
+                return ta != tb ? ta < tb : a->additive < b->additive;
+            });
+
+            numGroups = 0;
+            if (!numLive) { return; }
+
+            // * ------ Parameter table ------
+
+            float* params = new float[numLive * PARTICLE_PARAMS_SIZE];
+            for (int i = 0; i < numLive; ++i) {
+                ParticleEmitter const* e = order[i];
+                float* d = &params[i * PARTICLE_PARAMS_SIZE];
+
+                d[0] = e->startColor.x;
+                d[1] = e->startColor.y;
+                d[2] = e->startColor.z;
+                d[3] = e->startColor.w;
+                d[4] = e->endColor.x;
+                d[5] = e->endColor.y;
+                d[6] = e->endColor.z;
+                d[7] = e->endColor.w;
+                d[8] = e->startSize;
+                d[9] = e->endSize;
+                d[10] = 0.0f;
+                d[11] = 0.0f;
+            }
+
+            if (!paramBuffer) {
+                paramCapacity = numLive > PARTICLE_START_EMITTERS ? numLive : PARTICLE_START_EMITTERS;
+                paramBuffer = GPU::createBuffer(GL_TEXTURE_BUFFER, paramCapacity * PARTICLE_PARAMS_SIZE * sizeof(float), NULL, GL_STREAM_DRAW);
+
+                glGenTextures(1, &paramTex);
+                GLState::bindTexture(GL_TEXTURE_BUFFER, paramTex);
+                glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, paramBuffer);
+
+            } else if (numLive > paramCapacity) {
+                while (paramCapacity < numLive) { paramCapacity *= 2; }
+                GPU::bufferData(GL_TEXTURE_BUFFER, paramBuffer, paramCapacity * PARTICLE_PARAMS_SIZE * sizeof(float), NULL, GL_STREAM_DRAW);
+            }
+
+            GPU::bufferSubData(GL_TEXTURE_BUFFER, paramBuffer, 0, numLive * PARTICLE_PARAMS_SIZE * sizeof(float), params);
+            delete[] params;
+
+            // * ------ Pack each group's particles into its buffer ------
+            // ? The arrays are copied in as is so each one is still read as its own instanced attribute.
+
+            for (int start = 0, i = 1; i <= numLive; ++i) {
+                if (i < numLive && sameGroup(order[i], order[start])) { continue; }
+
+                int count = 0;
+                for (int j = start; j < i; ++j) { count += order[j]->numAlive; }
+
+                if (numGroups == numBuffers) {
+                    if (numBuffers == bufferCapacity) {
+                        bufferCapacity = bufferCapacity ? 2*bufferCapacity : PARTICLE_START_EMITTERS;
+                        PackedBuffer* temp = new PackedBuffer[bufferCapacity];
+                        for (int j = 0; j < numBuffers; ++j) { temp[j] = buffers[j]; }
+
+                        delete[] buffers;
+                        buffers = temp;
+                    }
+
+                    buffers[numBuffers++] = {0, 0};
+                }
+
+                PackedBuffer &b = buffers[numGroups];
+                if (count > b.capacity) { b.capacity = count > 2*b.capacity ? count : 2*b.capacity; }
+
+                if (!b.vboID) { b.vboID = GPU::createBuffer(GL_ARRAY_BUFFER, 5 * b.capacity * sizeof(float), NULL, GL_STREAM_DRAW); }
+                else { GPU::bufferData(GL_ARRAY_BUFFER, b.vboID, 5 * b.capacity * sizeof(float), NULL, GL_STREAM_DRAW); } // orphan the last frame's storage
+
+                if (count > emitterIDCapacity) {
+                    emitterIDCapacity = count;
+                    delete[] emitterIDs;
+                    emitterIDs = new float[emitterIDCapacity];
+                }
+
+                for (int j = start, offset = 0; j < i; ++j) {
+                    ParticleEmitter const* e = order[j];
+                    GLintptr at = offset * sizeof(float);
+                    GLsizeiptr bytes = e->numAlive * sizeof(float);
+
+                    GPU::bufferSubData(GL_ARRAY_BUFFER, b.vboID, at, bytes, e->posX);
+                    GPU::bufferSubData(GL_ARRAY_BUFFER, b.vboID, b.capacity * sizeof(float) + at, bytes, e->posY);
+                    GPU::bufferSubData(GL_ARRAY_BUFFER, b.vboID, 2 * b.capacity * sizeof(float) + at, bytes, e->life);
+                    GPU::bufferSubData(GL_ARRAY_BUFFER, b.vboID, 3 * b.capacity * sizeof(float) + at, bytes, e->lifetime);
+
+                    std::fill(&emitterIDs[offset], &emitterIDs[offset + e->numAlive], (float) j);
+                    offset += e->numAlive;
+                }
+
+                GPU::bufferSubData(GL_ARRAY_BUFFER, b.vboID, 4 * b.capacity * sizeof(float), count * sizeof(float), emitterIDs);
+                groups[numGroups++] = {b.vboID, count, b.capacity, textureOf(order[start]), order[start]->additive};
+                start = i;
+            }
+        };
+
+        int capture(ParticleDraw* &draws, int &drawCapacity) {
+            if (numGroups > drawCapacity) {
+                while (drawCapacity < numGroups) { drawCapacity = drawCapacity ? 2*drawCapacity : PARTICLE_START_EMITTERS; }
+                delete[] draws;
+                draws = new ParticleDraw[drawCapacity];
+            }
+
+            std::memcpy(draws, groups, numGroups * sizeof(ParticleDraw));
+            return numGroups;
+        };
+
+        void start(Shader* particleShader) {
+            shader = particleShader;
+
+            // unit quad centered on the particle (drawn as a triangle strip)
+            float vertices[8] = {0.5f, 0.5f, 0.5f, -0.5f, -0.5f, 0.5f, -0.5f, -0.5f};
+
+            glGenVertexArrays(1, &vaoID);
+            GLState::bindVertexArray(vaoID);
+
+            glGenBuffers(1, &quadID);
+            GLState::bindBuffer(GL_ARRAY_BUFFER, quadID);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+            glVertexAttribPointer(0, 2, GL_FLOAT, 0, 2 * sizeof(float), (void*) 0);
+            glEnableVertexAttribArray(0);
+
+            // posX, posY, life, lifetime, and the emitter advance once per particle
+            for (int i = 1; i <= 5; ++i) {
+                glEnableVertexAttribArray(i);
+                glVertexAttribDivisor(i, 1);
+            }
+
+            started = 1;
+        };
+
+        void draw(ParticleDraw const* draws, int numDraws) {
+            if (!numDraws) { return; }
+
+            GLState::bindVertexArray(vaoID);
+            shader->use();
+
+            GLState::bindTexture(PARTICLE_PARAMS_TEX_SLOT, GL_TEXTURE_BUFFER, paramTex);
+            shader->uploadInt("uParams", PARTICLE_PARAMS_TEX_SLOT);
+            shader->uploadInt("uTexture", 0);
+
+            // particles sit at the same depth as the sprites so the depth test would hide them behind anything drawn first
+            bool depthTest = glIsEnabled(GL_DEPTH_TEST);
+            glDisable(GL_DEPTH_TEST);
+
+            for (int i = 0; i < numDraws; ++i) {
+                ParticleDraw const &d = draws[i];
+
+                // point the instanced attributes at this group's arrays
+                GLState::bindBuffer(GL_ARRAY_BUFFER, d.vboID);
+                for (int j = 0; j < 5; ++j) { glVertexAttribPointer(j + 1, 1, GL_FLOAT, 0, 0, (void*) (j * d.capacity * sizeof(float))); }
+
+                if (d.texID) { GLState::bindTexture(0, GL_TEXTURE_2D, d.texID); }
+                shader->uploadInt("uTextured", d.texID != 0);
+
+                if (d.additive) { glBlendFunc(GL_SRC_ALPHA, GL_ONE); }
+                glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, d.numParticles);
+                RenderStats::countDraw();
+                if (d.additive) { glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); }
+            }
+
+            if (depthTest) { glEnable(GL_DEPTH_TEST); }
+        };
+
+        void stop() {
+            if (!started) { return; }
+
+            glDeleteVertexArrays(1, &vaoID);
+            glDeleteBuffers(1, &quadID);
+            GLState::forgetVertexArray(vaoID);
+            GLState::forgetBuffer(quadID);
+            started = 0;
+        };
+
+        void destroy() {
+            for (int i = 0; i < numEmitters; ++i) { delete emitters[i]; }
+            delete[] emitters;
+            emitters = nullptr;
+            numEmitters = 0;
+            capacity = 0;
+
+            // the render thread is stopped by now so the packed buffers can go
+            for (int i = 0; i < numBuffers; ++i) { GPU::deleteBuffers(1, &buffers[i].vboID); }
+            delete[] buffers;
+            buffers = nullptr;
+            numBuffers = 0;
+            bufferCapacity = 0;
+
+            if (paramBuffer) {
+                glDeleteTextures(1, &paramTex);
+                GLState::forgetTexture(paramTex);
+                GPU::deleteBuffers(1, &paramBuffer);
+                paramBuffer = paramTex = 0;
+                paramCapacity = 0;
+            }
+
+            delete[] groups;
+            delete[] order;
+            delete[] emitterIDs;
+            groups = nullptr;
+            order = nullptr;
+            emitterIDs = nullptr;
+            numGroups = orderCapacity = emitterIDCapacity = 0;
+        };
+    }
+}
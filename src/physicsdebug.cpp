@@ -0,0 +1,110 @@
+#include <Dralgeer/physicsdebug.h>
+
+namespace Dralgeer {
+    namespace PhysicsDebug {
+        bool enabled = 0;
+        bool showColliders = 1;
+        bool showContacts = 1;
+        bool showBounds = 0;
+
+        namespace {
+            // colors for the different parts of the overlay
+            static glm::vec3 const rigidColor(0.2f, 0.9f, 0.3f);
+            static glm::vec3 const staticColor(0.3f, 0.5f, 1.0f);
+            static glm::vec3 const kinematicColor(1.0f, 0.85f, 0.2f);
+            static glm::vec3 const boundsColor(0.45f, 0.45f, 0.45f);
+            static glm::vec3 const contactColor(0.8824f, 0.0039f, 0.0039f);
+            static glm::vec3 const normalColor(1.0f, 0.5f, 0.0f);
+
+            inline glm::vec2 toVec(ZMath::Vec2D const &v) { return glm::vec2(v.x, v.y); };
+
+            inline void emitCircle(Primitives::Circle const &circle, glm::vec3 const &color) {
+                glm::vec2 c = toVec(circle.c);
+
+                if (showColliders) { DebugDraw::addCircle(c, circle.r, color); }
+                if (showBounds) { DebugDraw::addBox2D(c, glm::vec2(2.0f * circle.r), 0.0f, boundsColor); }
+            };
+
+            inline void emitAABB(Primitives::AABB const &aabb, glm::vec3 const &color) {
+                glm::vec2 dimensions = toVec(aabb.getHalfsize() * 2.0f);
+
+                // the AABB is its own bounding box
+                if (showColliders) { DebugDraw::addBox2D(toVec(aabb.pos), dimensions, 0.0f, color); }
+                else if (showBounds) { DebugDraw::addBox2D(toVec(aabb.pos), dimensions, 0.0f, boundsColor); }
+            };
+
+            inline void emitBox(Primitives::Box2D const &box, glm::vec3 const &color) {
+                // use the box's cached rotation matrix so the outline matches what the handler actually tests against
+                ZMath::Vec2D h = box.getHalfsize();
+                ZMath::Vec2D local[4] = {-h, ZMath::Vec2D(-h.x, h.y), h, ZMath::Vec2D(h.x, -h.y)};
+                glm::vec2 vertices[4];
+
+                glm::vec2 min(INFINITY), max(-INFINITY);
+                for (int i = 0; i < 4; ++i) {
+                    vertices[i] = toVec(box.rot * local[i] + box.pos);
+                    min = glm::min(min, vertices[i]);
+                    max = glm::max(max, vertices[i]);
+                }
+
+                if (showColliders) { DebugDraw::addPolygon(vertices, 4, color); }
+                if (showBounds) { DebugDraw::addBox2D((min + max) * 0.5f, max - min, 0.0f, boundsColor); }
+            };
+        }
+
+        void emit(Zeta::Handler const &handler) {
+            // * Colliders
+
+            Zeta::RigidBodies const &rbs = handler.getRigidBodies();
+            for (int i = 0; i < rbs.count; ++i) {
+                Primitives::RigidBody2D* rb = rbs.rigidBodies[i];
+
+                switch(rb->colliderType) {
+                    case Primitives::RIGID_CIRCLE_COLLIDER: { emitCircle(rb->collider.circle, rigidColor); break; }
+                    case Primitives::RIGID_AABB_COLLIDER: { emitAABB(rb->collider.aabb, rigidColor); break; }
+                    case Primitives::RIGID_BOX2D_COLLIDER: { emitBox(rb->collider.box, rigidColor); break; }
+                    default: { break; } // custom colliders and bodies without one have nothing to draw
+                }
+            }
+
+            Zeta::StaticBodies const &sbs = handler.getStaticBodies();
+            for (int i = 0; i < sbs.count; ++i) {
+                Primitives::StaticBody2D* sb = sbs.staticBodies[i];
+
+                switch(sb->colliderType) {
+                    case Primitives::STATIC_CIRCLE_COLLIDER: { emitCircle(sb->collider.circle, staticColor); break; }
+                    case Primitives::STATIC_AABB_COLLIDER: { emitAABB(sb->collider.aabb, staticColor); break; }
+                    case Primitives::STATIC_BOX2D_COLLIDER: { emitBox(sb->collider.box, staticColor); break; }
+                    default: { break; }
+                }
+            }
+
+            Zeta::KinematicBodies const &kbs = handler.getKinematicBodies();
+            for (int i = 0; i < kbs.count; ++i) {
+                Primitives::KinematicBody2D* kb = kbs.kinematicBodies[i];
+
+                switch(kb->colliderType) {
+                    case Primitives::KINEMATIC_CIRCLE_COLLIDER: { emitCircle(kb->collider.circle, kinematicColor); break; }
+                    case Primitives::KINEMATIC_AABB_COLLIDER: { emitAABB(kb->collider.aabb, kinematicColor); break; }
+                    case Primitives::KINEMATIC_BOX2D_COLLIDER: { emitBox(kb->collider.box, kinematicColor); break; }
+                    default: { break; }
+                }
+            }
+
+            // * Contacts
+
+            if (!showContacts) { return; }
+
+            Zeta::DebugContacts const &contacts = handler.getDebugContacts();
+            for (int i = 0; i < contacts.count; ++i) {
+                glm::vec2 p = toVec(contacts.contacts[i].point);
+                glm::vec2 n = toVec(contacts.contacts[i].normal);
+
+                // mark the point with a small cross and draw the normal out of it
+                DebugDraw::addLine2D(p - glm::vec2(PHYSICS_DEBUG_MARKER_SIZE), p + glm::vec2(PHYSICS_DEBUG_MARKER_SIZE), contactColor);
+                DebugDraw::addLine2D(p + glm::vec2(-PHYSICS_DEBUG_MARKER_SIZE, PHYSICS_DEBUG_MARKER_SIZE),
+                        p + glm::vec2(PHYSICS_DEBUG_MARKER_SIZE, -PHYSICS_DEBUG_MARKER_SIZE), contactColor);
+                DebugDraw::addLine2D(p, p + n * PHYSICS_DEBUG_NORMAL_LENGTH, normalColor);
+            }
+        };
+    }
+}
@@ -2,8 +2,89 @@
 #include <Zeta2D/zmath2D.h>
 #include <Dralgeer/window.h>
 #include <Dralgeer/assetpool.h>
+#include <Dralgeer/animation.h>
+#include <Dralgeer/lighting.h>
+#include <Dralgeer/material.h>
+#include <Dralgeer/discovery.h>
 
 namespace Dralgeer {
+    // * ===============================================
+    // * SpriteVertex Stuff
+
+    unsigned int SpriteVertex::createVertexArray(unsigned int vbo, unsigned int ebo) {
+        static GPU::VertexAttribute const attributes[7] = {
+            {2, 0}, // position
+            {4, COLOR_OFFSET},
+            {2, TEX_COORDS_OFFSET},
+            {1, TEX_ID_OFFSET},
+            {1, ENTITY_ID_OFFSET},
+            {3, ANIM_OFFSET},
+            {1, MATERIAL_OFFSET}
+        };
+
+        return GPU::createVertexArray(vbo, ebo, VERTEX_SIZE_BYTES, attributes, 7);
+    };
+
+    void SpriteVertex::load(float* vertices, SpriteRenderer const* spr, int texID) {
+        // signed distance field and premultiplied textures are sampled differently so flag them through the ID
+        if (texID >= 0 && spr->sprite.texture->sdf) { texID += SDF_TEX_ID_OFFSET; }
+        else if (texID >= 0 && spr->sprite.texture->premultiplied) { texID += PREMULTIPLIED_TEX_ID_OFFSET; }
+
+        glm::mat4 transformMat(1);
+        Transform const &t = spr->transform;
+
+        if (!ZMath::compare(t.rotation, 0.0f)) {
+            transformMat = glm::translate(transformMat, glm::vec3(t.pos.x, t.pos.y, 0.0f));
+            transformMat = glm::rotate(transformMat, (float) glm::radians(t.rotation), glm::vec3(0, 0, 1));
+            transformMat = glm::scale(transformMat, glm::vec3(t.scale.x, t.scale.y, 1.0f));
+        }
+
+        // add vertices with the appropriate properties
+        // this loop is slightly inefficient compared to just writing out all 4 cases by hand, but I really don't wanna do that
+        float xAdd = 1.0f, yAdd = 1.0f;
+        int offset = 0;
+
+        for (int i = 0; i < 4; ++i) {
+            // account for each vertex
+            if (i == 1) { yAdd = 0.0f; }
+            else if (i == 2) { xAdd = 0.0f; }
+            else if (i == 3) { yAdd = 1.0f; }
+
+            glm::vec4 currPos(t.pos.x + (xAdd * t.scale.x), t.pos.y + (yAdd * t.scale.y), 0.0f, 1.0f);
+            if (!ZMath::compare(t.rotation, 0.0f)) { currPos = transformMat * glm::vec4(xAdd, yAdd, 0.0f, 1.0f); }
+
+            // load position
+            vertices[offset] = currPos.x;
+            vertices[offset + 1] = currPos.y;
+
+            // load color
+            vertices[offset + 2] = spr->color.x;
+            vertices[offset + 3] = spr->color.y;
+            vertices[offset + 4] = spr->color.z;
+            vertices[offset + 5] = spr->color.w;
+
+            // load texture coords
+            vertices[offset + 6] = spr->sprite.texCoords[i].x;
+            vertices[offset + 7] = spr->sprite.texCoords[i].y;
+            
+            // load texture IDs
+            vertices[offset + 8] = texID;
+
+            // load entity IDs
+            vertices[offset + 9] = spr->entityID;
+
+            // load animation
+            vertices[offset + 10] = spr->animClip;
+            vertices[offset + 11] = spr->animStart;
+            vertices[offset + 12] = spr->animRate;
+
+            // load material
+            vertices[offset + 13] = spr->material;
+
+            offset += VERTEX_SIZE;
+        }
+    };
+
     // * ===============================================
     // * StaticBatch Stuff
 
@@ -15,26 +96,26 @@ namespace Dralgeer {
     // Note we do not need to delete the textures as the AssetPool will take care of that for us.
 
     StaticBatch::~StaticBatch() {
+        if (builder.joinable()) { builder.join(); } // the worker writes into this batch so it has to finish first
+        delete[] vertices;
+        delete[] indices;
+
+        if (!vboID) { return; }
+
         // free the GPU
         glDeleteVertexArrays(1, &vaoID);
-        glDeleteBuffers(1, &vboID);
-        glDeleteBuffers(1, &eboID);
+        GPU::deleteBuffers(1, &vboID);
+        GPU::deleteBuffers(1, &eboID);
 
-        // unbind everything
-        glBindVertexArray(0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        // deleting the VAO unbinds it
+        GLState::forgetVertexArray(vaoID);
     };
 
-    void StaticBatch::init(SpriteRenderer** spr, int size) {
-        float* vertices = new float[size*SPRITE_SIZE];
-        unsigned int* indices = new unsigned int[size*6];
+    void StaticBatch::build(SpriteRenderer* const* spr, int size) {
+        vertices = new float[size*SPRITE_SIZE];
+        indices = new unsigned int[size*6];
         numSprites = size;
 
-        // generate and bind a vertex array object
-        glGenVertexArrays(1, &vaoID);
-        glBindVertexArray(vaoID);
-
         // populate the vertices and indices lists
         int offset = 0, iOffset = 0, iIndex = 0;
 
@@ -60,52 +141,9 @@ namespace Dralgeer {
 
             ADDED_TEX:
 
-            glm::mat4 transformMat(1);
-            Transform t = spr[i]->transform; // for readabiility (will probably remove later)
+            SpriteVertex::load(&vertices[offset], spr[i], texID);
+            offset += SPRITE_SIZE;
 
-            if (!ZMath::compare(t.rotation, 0.0f)) {
-                transformMat = glm::translate(transformMat, glm::vec3(t.pos.x, t.pos.y, 0.0f));
-                transformMat = glm::rotate(transformMat, (float) glm::radians(t.rotation), glm::vec3(0, 0, 1));
-                transformMat = glm::scale(transformMat, glm::vec3(t.scale.x, t.scale.y, 1.0f));
-            }
-
-            // add vertices with the appropriate properties
-            // this loop is slightly inefficient compared to just writing out all 4 cases by hand, but I really don't wanna do that
-            float xAdd = 1.0f, yAdd = 1.0f;
-
-            // populate vertices
-            for (int j = 0; j < 4; ++j) {
-                // account for each vertex
-                if (j == 1) { yAdd = 0.0f; }
-                else if (j == 2) { xAdd = 0.0f; }
-                else if (j == 3) { yAdd = 1.0f; }
-
-                glm::vec4 currPos(t.pos.x + (xAdd * t.scale.x), t.pos.y + (yAdd * t.scale.y), 0.0f, 1.0f);
-                if (!ZMath::compare(t.rotation, 0.0f)) { currPos = transformMat * glm::vec4(xAdd, yAdd, 0.0f, 1.0f); }
-
-                // load position
-                vertices[offset] = currPos.x;
-                vertices[offset + 1] = currPos.y;
-
-                // load color
-                vertices[offset + 2] = spr[i]->color.x;
-                vertices[offset + 3] = spr[i]->color.y;
-                vertices[offset + 4] = spr[i]->color.z;
-                vertices[offset + 5] = spr[i]->color.w;
-
-                // load texture coords
-                vertices[offset + 6] = spr[i]->sprite.texCoords[i].x;
-                vertices[offset + 7] = spr[i]->sprite.texCoords[i].y;
-                
-                // load texture IDs
-                vertices[offset + 8] = texID;
-
-                // load entity IDs
-                vertices[offset + 9] = spr[i]->entityID;
-
-                offset += VERTEX_SIZE;
-            }
-        
             // populate indices
             indices[iIndex] = iOffset;
             indices[iIndex + 1] = iOffset + 1;
@@ -118,161 +156,129 @@ namespace Dralgeer {
             iOffset += 4;
             iIndex += 6;
         }
-
-        // allocate space for the vertices
-        glGenBuffers(1, &vboID);
-        glBindBuffer(GL_ARRAY_BUFFER, vboID);
-        glBufferData(GL_ARRAY_BUFFER, size*SPRITE_SIZE, vertices, GL_STATIC_DRAW);
-
-        // generate the ebo
-        glGenBuffers(1, &eboID);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eboID);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, size*6, indices, GL_STATIC_DRAW);
-
-        // set the parameters
-        glVertexAttribPointer(0, 2, GL_FLOAT, 0, VERTEX_SIZE_BYTES, (void*) 0);
-        glVertexAttribPointer(1, 4, GL_FLOAT, 0, VERTEX_SIZE_BYTES, (void*) COLOR_OFFSET);
-        glVertexAttribPointer(2, 2, GL_FLOAT, 0, VERTEX_SIZE_BYTES, (void*) TEX_COORDS_OFFSET);
-        glVertexAttribPointer(3, 1, GL_FLOAT, 0, VERTEX_SIZE_BYTES, (void*) TEX_ID_OFFSET);
-        glVertexAttribPointer(4, 1, GL_FLOAT, 0, VERTEX_SIZE_BYTES, (void*) ENTITY_ID_OFFSET);
-        glEnableVertexAttribArray(0);
-        glEnableVertexAttribArray(1);
-        glEnableVertexAttribArray(2);
-        glEnableVertexAttribArray(3);
-        glEnableVertexAttribArray(4);
-
-        // free the memory
-        delete[] vertices;
-        delete[] indices;
     };
 
-    void StaticBatch::render(Shader const &currShader, Camera const &cam) {
-        // bind everything
-        glBindVertexArray(vaoID);
-        glEnableVertexAttribArray(0);
-        glEnableVertexAttribArray(1);
+    bool StaticBatch::upload(long long budget) {
+        if (state == STATIC_BATCH_BUILDING) {
+            if (!built.load(std::memory_order_acquire)) { return 0; }
 
-        // use shader
-        currShader.use();
-        currShader.uploadMat4("uProjection", cam.proj);
-        currShader.uploadMat4("uView", cam.view);
+            builder.join();
+            if (error) { std::rethrow_exception(error); }
+            state = STATIC_BATCH_UPLOADING;
+        }
 
-        // bind textures
-        for (int i = 0; i < numTextures; ++i) {
-            glActiveTexture(GL_TEXTURE0 + i);
-            textures[i]->bind();
+        if (state != STATIC_BATCH_UPLOADING) { return state == STATIC_BATCH_READY; }
+
+        long long vertexBytes = numSprites*SPRITE_SIZE_BYTES, indexBytes = numSprites*6*sizeof(unsigned int);
+
+        // the buffers start out empty and are filled a chunk at a time (the vertices and then the indices)
+        if (!vboID) {
+            vboID = GPU::createBuffer(GL_ARRAY_BUFFER, vertexBytes, NULL, GL_STATIC_DRAW);
+            eboID = GPU::createBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBytes, NULL, GL_STATIC_DRAW);
         }
 
-        currShader.uploadIntArr("uTexture", TexSlots::texSlots, 16);
+        while (uploaded < vertexBytes + indexBytes && budget) {
+            bool vertex = uploaded < vertexBytes;
+            long long offset = vertex ? uploaded : uploaded - vertexBytes;
+            long long left = (vertex ? vertexBytes : indexBytes) - offset;
+            long long n = budget < 0 || left < budget ? left : budget;
 
-        glDrawElements(GL_TRIANGLES, 6*numSprites, GL_UNSIGNED_INT, 0);
+            if (vertex) { GPU::bufferSubData(GL_ARRAY_BUFFER, vboID, offset, n, (char const*) vertices + offset); }
+            else { GPU::bufferSubData(GL_ELEMENT_ARRAY_BUFFER, eboID, offset, n, (char const*) indices + offset); }
 
-        currShader.detach();
+            uploaded += n;
+            if (budget > 0) { budget -= n; }
+        }
 
-        // unbind everything
-        glDisableVertexAttribArray(0);
-        glDisableVertexAttribArray(1);
-        glBindVertexArray(0);
-    };
+        if (uploaded < vertexBytes + indexBytes) { return 0; }
 
-    // * ===============================================
-    // * DynamicBatch Stuff
+        // point a vertex array object at them and free the memory
+        vaoID = SpriteVertex::createVertexArray(vboID, eboID);
 
-    DynamicBatch::DynamicBatch(DynamicBatch const &batch) { throw std::runtime_error("[ERROR] Cannot constructor a DynamicBatch from another DynamicBatch."); };
-    DynamicBatch::DynamicBatch(DynamicBatch &&batch) { throw std::runtime_error("[ERROR] Cannot constructor a DynamicBatch from another DynamicBatch."); };
-    DynamicBatch& DynamicBatch::operator = (DynamicBatch const &batch) { throw std::runtime_error("[ERROR] Cannot reassign a DynamicBatch object. Do NOT use the '=' operator."); };
-    DynamicBatch& DynamicBatch::operator = (DynamicBatch &&batch) { throw std::runtime_error("[ERROR] Cannot reassign a DynamicBatch object. Do NOT use the '=' operator."); };
-    
-    // Note we do not need to free the textures as the AssetPool will handle that for us.
-    DynamicBatch::~DynamicBatch() {
-        for (int i = 0; i < numSprites; ++i) { delete sprites[i]; }
+        delete[] vertices;
+        delete[] indices;
+        vertices = nullptr;
+        indices = nullptr;
 
-        // delete the vao, vbo, and ebo
-        glDeleteVertexArrays(1, &vaoID);
-        glDeleteBuffers(1, &vboID);
-        glDeleteBuffers(1, &eboID);
+        state = STATIC_BATCH_READY;
+        return 1;
+    };
 
-        // unbind everything
-        glBindVertexArray(0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    void StaticBatch::init(SpriteRenderer** spr, int size) {
+        build(spr, size);
+        state = STATIC_BATCH_UPLOADING;
+        upload(-1);
     };
 
-    void DynamicBatch::loadVertexProperties(int index) {
-        int offset = index * SPRITE_SIZE;
+    void StaticBatch::initAsync(SpriteRenderer** spr, int size) {
+        // the caller's array can be gone by the time the worker gets to it
+        SpriteRenderer** list = new SpriteRenderer*[size];
+        for (int i = 0; i < size; ++i) { list[i] = spr[i]; }
 
-        // Texture ID
-        int texID = -1;
-        if (sprites[index]->sprite.texture) {
-            for (int i = 0; i < numTextures; ++i) {
-                if (textures[i] == sprites[index]->sprite.texture) {
-                    texID = i;
-                    break;
-                }
-            }
-        }
+        state = STATIC_BATCH_BUILDING;
 
-        glm::mat4 transformMat(1);
-        Transform t = sprites[index]->transform;
+        builder = std::thread([this, list, size] {
+            try { build(list, size); }
+            catch (...) { error = std::current_exception(); }
 
-        if (!ZMath::compare(t.rotation, 0.0f)) {
-            transformMat = glm::translate(transformMat, glm::vec3(t.pos.x, t.pos.y, 0.0f));
-            transformMat = glm::rotate(transformMat, (float) glm::radians(t.rotation), glm::vec3(0, 0, 1));
-            transformMat = glm::scale(transformMat, glm::vec3(t.scale.x, t.scale.y, 1.0f));
-        }
+            delete[] list;
+            built.store(1, std::memory_order_release);
+        });
+    };
 
-        // add vertices with the appropriate properties
-        // this loop is slightly inefficient compared to just writing out all 4 cases by hand, but I really don't wanna do that
-        float xAdd = 1.0f, yAdd = 1.0f;
+    void StaticBatch::render(Shader const &currShader) {
+        if (state != STATIC_BATCH_READY && !upload(STATIC_BATCH_UPLOAD_BUDGET)) { return; } // nothing is drawn until it is all uploaded
 
-        for (int i = 0; i < 4; ++i) {
-            // account for each vertex
-            if (i == 1) { yAdd = 0.0f; }
-            else if (i == 2) { xAdd = 0.0f; }
-            else if (i == 3) { yAdd = 1.0f; }
+        // bind everything (the state cache skips whatever is already bound)
+        GLState::bindVertexArray(vaoID);
+        currShader.use();
 
-            glm::vec4 currPos(t.pos.x + (xAdd * t.scale.x), t.pos.y + (yAdd * t.scale.y), 0.0f, 1.0f);
-            if (!ZMath::compare(t.rotation, 0.0f)) { currPos = transformMat * glm::vec4(xAdd, yAdd, 0.0f, 1.0f); }
+        // bind textures
+        for (int i = 0; i < numTextures; ++i) { GLState::bindTexture(i, GL_TEXTURE_2D, textures[i]->texID); }
 
-            // load position
-            vertices[offset] = currPos.x;
-            vertices[offset + 1] = currPos.y;
+        currShader.uploadIntArr("uTexture", TexSlots::texSlots, 16);
+        Animation::bind(currShader);
+        Lighting::bind(currShader);
+        Materials::bind(currShader);
+        Discovery::bind(currShader);
 
-            // load color
-            vertices[offset + 2] = sprites[index]->color.x;
-            vertices[offset + 3] = sprites[index]->color.y;
-            vertices[offset + 4] = sprites[index]->color.z;
-            vertices[offset + 5] = sprites[index]->color.w;
+        glDrawElements(GL_TRIANGLES, 6*numSprites, GL_UNSIGNED_INT, 0);
+        RenderStats::countBatch(numSprites);
+    };
 
-            // load texture coords
-            vertices[offset + 6] = sprites[index]->sprite.texCoords[i].x;
-            vertices[offset + 7] = sprites[index]->sprite.texCoords[i].y;
-            
-            // load texture IDs
-            vertices[offset + 8] = texID;
+    // * ===============================================
+    // * Batch Stuff
 
-            // load entity IDs
-            vertices[offset + 9] = sprites[index]->entityID;
+    // Note we do not need to free the textures as the AssetPool will handle that for us.
+    template <typename Traits>
+    Batch<Traits>::~Batch() {
+        if (Traits::ownsSprites) { for (int i = 0; i < numSprites; ++i) { delete sprites[i]; }}
+        delete next;
+        delete[] keys;
+        delete[] slots;
+        if (!started) { return; }
 
-            offset += VERTEX_SIZE;
-        }
+        // delete the vao, vbo, and ebo
+        glDeleteVertexArrays(1, &vaoID);
+        GPU::deleteBuffers(1, &vboID);
+        GPU::deleteBuffers(1, &eboID);
+
+        // deleting the VAO unbinds it
+        GLState::forgetVertexArray(vaoID);
     };
 
-    void DynamicBatch::start() {
-        // generate and bind a vertex array object
-        glGenVertexArrays(1, &vaoID);
-        glBindVertexArray(vaoID);
+    template <typename Traits>
+    void Batch<Traits>::start() {
+        if (started) { return; }
 
         // allocate space for the vertices
-        glGenBuffers(1, &vboID);
-        glBindBuffer(GL_ARRAY_BUFFER, vboID);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_DYNAMIC_DRAW);
+        vboID = GPU::createBuffer(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_DYNAMIC_DRAW);
 
         // * ------ Generate the Indices ------
 
-        unsigned int indices[MAX_RENDER_INDICES_LIST_SIZE];
+        unsigned int* indices = new unsigned int[6 * Traits::capacity];
         int offset = 0;
-        for (int i = 0; i < MAX_RENDER_INDICES_LIST_SIZE; i += 6) {
+        for (int i = 0; i < 6 * Traits::capacity; i += 6) {
             indices[i] = offset;
             indices[i + 1] = offset + 1;
             indices[i + 2] = offset + 2;
@@ -286,331 +292,253 @@ namespace Dralgeer {
 
         // * ----------------------------------
 
-        glGenBuffers(1, &eboID);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eboID);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-        glVertexAttribPointer(0, 2, GL_FLOAT, 0, VERTEX_SIZE_BYTES, (void*) 0);
-        glVertexAttribPointer(1, 4, GL_FLOAT, 0, VERTEX_SIZE_BYTES, (void*) COLOR_OFFSET);
-        glVertexAttribPointer(2, 2, GL_FLOAT, 0, VERTEX_SIZE_BYTES, (void*) TEX_COORDS_OFFSET);
-        glVertexAttribPointer(3, 1, GL_FLOAT, 0, VERTEX_SIZE_BYTES, (void*) TEX_ID_OFFSET);
-        glVertexAttribPointer(4, 1, GL_FLOAT, 0, VERTEX_SIZE_BYTES, (void*) ENTITY_ID_OFFSET);
-        glEnableVertexAttribArray(0);
-        glEnableVertexAttribArray(1);
-        glEnableVertexAttribArray(2);
-        glEnableVertexAttribArray(3);
-        glEnableVertexAttribArray(4);
+        eboID = GPU::createBuffer(GL_ELEMENT_ARRAY_BUFFER, 6 * Traits::capacity * sizeof(unsigned int), indices, GL_STATIC_DRAW);
+        delete[] indices;
+
+        vaoID = Traits::Vertex::createVertexArray(vboID, eboID);
+        started = 1;
     };
 
-    void DynamicBatch::render(Shader const &currShader, Camera const &cam) {
-        bool rebuffer = 0;
+    template <typename Traits>
+    void Batch<Traits>::render(Shader const &currShader) {
+        int first = numSprites, last = -1; // range of dirty sprites
 
-        for (int i = 0; i < numSprites; ++i) {
-            if (sprites[i]->isDirty) {
-                loadVertexProperties(i);
-                sprites[i]->isDirty = 0;
-                rebuffer = 1;
+        if (ySort) {
+            sortByY();
+
+            for (int i = 0; i < numSprites; ++i) {
+                if (sprites[i]->isDirty) {
+                    Traits::Vertex::load(&vertices[i * SPRITE_FLOATS], sprites[i], slots[i] < MAX_TEXTURES ? slots[i] : -1);
+                    sprites[i]->isDirty = 0;
+                    if (i < first) { first = i; }
+                    last = i;
+                }
+            }
+
+        } else {
+            // a sprite's group is its texture slot
+            for (int g = 0, i = 0; g < NUM_GROUPS; ++g) {
+                int texID = g < MAX_TEXTURES ? g : -1;
+
+                for (; i < groupEnd[g]; ++i) {
+                    if (sprites[i]->isDirty) {
+                        Traits::Vertex::load(&vertices[i * SPRITE_FLOATS], sprites[i], texID);
+                        sprites[i]->isDirty = 0;
+                        if (i < first) { first = i; }
+                        last = i;
+                    }
+                }
             }
         }
 
         // rebuffer data if any of the sprites are dirty
-        if (rebuffer) {
-            glBindBuffer(GL_ARRAY_BUFFER, vboID);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-        }
+        if (last >= 0) {
+            if (Traits::upload == BATCH_UPLOAD_ALL) {
+                first = 0;
+                last = numSprites - 1;
+            }
 
-        // bind everything
-        glBindVertexArray(vaoID);
-        glEnableVertexAttribArray(0);
-        glEnableVertexAttribArray(1);
+            GPU::bufferSubData(GL_ARRAY_BUFFER, vboID, first * SPRITE_FLOATS * sizeof(float), (last - first + 1) * SPRITE_FLOATS * sizeof(float),
+                    &vertices[first * SPRITE_FLOATS]);
+        }
 
-        // use shader
+        // bind everything (the state cache skips whatever is already bound)
+        GLState::bindVertexArray(vaoID);
         currShader.use();
-        currShader.uploadMat4("uProjection", cam.proj);
-        currShader.uploadMat4("uView", cam.view);
 
         // bind textures
-        for (int i = 0; i < numTextures; ++i) {
-            glActiveTexture(GL_TEXTURE0 + i);
-            textures[i]->bind();
-        }
+        for (int i = 0; i < MAX_TEXTURES; ++i) { if (textures[i]) { GLState::bindTexture(i, GL_TEXTURE_2D, textures[i]->texID); }}
 
         currShader.uploadIntArr("uTexture", TexSlots::texSlots, 16);
+        Animation::bind(currShader);
+        Lighting::bind(currShader);
+        Materials::bind(currShader);
+        Discovery::bind(currShader);
 
         glDrawElements(GL_TRIANGLES, 6*numSprites, GL_UNSIGNED_INT, 0);
-
-        currShader.detach();
-
-        // unbind everything
-        glDisableVertexAttribArray(0);
-        glDisableVertexAttribArray(1);
-        glBindVertexArray(0);
+        RenderStats::countBatch(numSprites);
     };
 
-    bool DynamicBatch::destroyIfExists(SpriteRenderer* spr) {
+    template <typename Traits>
+    bool Batch<Traits>::destroyIfExists(SpriteRenderer* spr) {
         for (int i = 0; i < numSprites; ++i) {
             if (sprites[i] == spr) {
-                for (int j = i; j < numSprites - 1; ++j) {
-                    sprites[j] = sprites[j + 1];
-                    sprites[j]->isDirty = 1;
-                }
-
-                numSprites--;
-                return 1;
-            }
-        }
-
-        return 0;
-    };
-
-    void DynamicBatch::addSprite(SpriteRenderer* spr) {
-        if (numSprites < MAX_RENDER_BATCH_SIZE) {
-            sprites[numSprites] = spr;
-            sprites[numSprites]->isDirty = 1;
-
-            // add texture if the sprite has a texture and we don't already have that texture
-            // ensure it is within the max number of textures, too (tbh I think the setup I have for the textures is wrong)
-            if (spr->sprite.texture && numTextures < MAX_TEXTURES) {
-                for (int i = 0; i < numTextures; ++i) { if (textures[i] == spr->sprite.texture) { goto ADDED; }}
-                textures[numTextures++] = spr->sprite.texture;
-
-            } else if (numTextures >= MAX_TEXTURES) { // todo will remove the logging stuff but this is useful for debugging
-                std::cout << "[INFO] Maximum number of textures reached.\n";
-            }
-
-            ADDED:
-            numSprites++;
-        }
-    };
-
-    // void DynamicBatch::addSprites(SpriteRenderer** spr, int size) {};
-
-    bool DynamicBatch::hasTexture(Texture* tex) const {
-        if (!tex) { return 0; }
-        for (int i = 0; i < numTextures; ++i) { if (textures[i] == tex) { return 1; }}
-        return 0;
-    };
+                if (ySort) {
+                    // keep the order so the sort has nothing new to do
+                    int slot = slots[i];
+                    for (int j = i; j < numSprites - 1; ++j) {
+                        move(j + 1, j);
+                        keys[j] = keys[j + 1];
+                        slots[j] = slots[j + 1];
+                    }
 
-    // * ===============================================
-    // * EditorBatch Stuff
+                    --numSprites;
 
-    EditorBatch::EditorBatch(EditorBatch const &batch) { throw std::runtime_error("[ERROR] Cannot constructor a EditorBatch from another EditorBatch."); };
-    EditorBatch::EditorBatch(EditorBatch &&batch) { throw std::runtime_error("[ERROR] Cannot constructor a EditorBatch from another EditorBatch."); };
-    EditorBatch& EditorBatch::operator = (EditorBatch const &batch) { throw std::runtime_error("[ERROR] Cannot reassign a EditorBatch object. Do NOT use the '=' operator."); };
-    EditorBatch& EditorBatch::operator = (EditorBatch &&batch) { throw std::runtime_error("[ERROR] Cannot reassign a EditorBatch object. Do NOT use the '=' operator."); };
-    
-    // Do not have to delete the textures as the AssetPool should take care of that for us.
-    EditorBatch::~EditorBatch() {
-        for (int i = 0; i < numSprites; ++i) { delete sprites[i]; }
+                    // free the texture's slot once its last sprite is gone
+                    if (slot < MAX_TEXTURES) {
+                        bool used = 0;
+                        for (int j = 0; j < numSprites && !used; ++j) { used = slots[j] == slot; }
 
-        // delete the vao, vbo, and ebo
-        glDeleteVertexArrays(1, &vaoID);
-        glDeleteBuffers(1, &vboID);
-        glDeleteBuffers(1, &eboID);
+                        if (!used) {
+                            textures[slot] = nullptr;
+                            --numTextures;
+                        }
+                    }
 
-        // unbind everything
-        glBindVertexArray(0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    };
+                    return 1;
+                }
 
-    void EditorBatch::loadVertexProperties(int index) {
-        int offset = index * SPRITE_SIZE;
+                int group = 0;
+                while (groupEnd[group] <= i) { ++group; }
 
-        // Texture ID
-        int texID = -1;
-        if (sprites[index]->sprite.texture) {
-            for (int i = 0; i < numTextures; ++i) {
-                if (textures[i] == sprites[index]->sprite.texture) {
-                    texID = i;
-                    break;
+                // fill the hole with the last sprite of each group from this one on
+                int hole = i;
+                for (int g = group; g < NUM_GROUPS; ++g) {
+                    int last = groupEnd[g] - 1;
+                    if (last != hole) { move(last, hole); }
+                    hole = last;
+                    --groupEnd[g];
                 }
-            }
-        }
 
-        glm::mat4 transformMat(1);
-        Transform t = sprites[index]->transform;
+                // free the texture's slot once its last sprite is gone
+                if (group < MAX_TEXTURES && groupEnd[group] == (group ? groupEnd[group - 1] : 0)) {
+                    textures[group] = nullptr;
+                    --numTextures;
+                }
 
-        if (!ZMath::compare(t.rotation, 0.0f)) {
-            transformMat = glm::translate(transformMat, glm::vec3(t.pos.x, t.pos.y, 0.0f));
-            transformMat = glm::rotate(transformMat, (float) glm::radians(t.rotation), glm::vec3(0, 0, 1));
-            transformMat = glm::scale(transformMat, glm::vec3(t.scale.x, t.scale.y, 1.0f));
+                --numSprites;
+                return 1;
+            }
         }
 
-        // add vertices with the appropriate properties
-        // this loop is slightly inefficient compared to just writing out all 4 cases by hand, but I really don't wanna do that
-        float xAdd = 1.0f, yAdd = 1.0f;
-
-        for (int i = 0; i < 4; ++i) {
-            // account for each vertex
-            if (i == 1) { yAdd = 0.0f; }
-            else if (i == 2) { xAdd = 0.0f; }
-            else if (i == 3) { yAdd = 1.0f; }
-
-            glm::vec4 currPos(t.pos.x + (xAdd * t.scale.x), t.pos.y + (yAdd * t.scale.y), 0.0f, 1.0f);
-            if (!ZMath::compare(t.rotation, 0.0f)) { currPos = transformMat * glm::vec4(xAdd, yAdd, 0.0f, 1.0f); }
-
-            // load position
-            vertices[offset] = currPos.x;
-            vertices[offset + 1] = currPos.y;
-
-            // load color
-            vertices[offset + 2] = sprites[index]->color.x;
-            vertices[offset + 3] = sprites[index]->color.y;
-            vertices[offset + 4] = sprites[index]->color.z;
-            vertices[offset + 5] = sprites[index]->color.w;
-
-            // load texture coords
-            vertices[offset + 6] = sprites[index]->sprite.texCoords[i].x;
-            vertices[offset + 7] = sprites[index]->sprite.texCoords[i].y;
-            
-            // load texture IDs
-            vertices[offset + 8] = texID;
-
-            // load entity IDs
-            vertices[offset + 9] = sprites[index]->entityID;
-
-            offset += VERTEX_SIZE;
-        }
+        return 0;
     };
 
-    void EditorBatch::start() {
-        // generate and bind a vertex array object
-        glGenVertexArrays(1, &vaoID);
-        glBindVertexArray(vaoID);
+    template <typename Traits>
+    bool Batch<Traits>::addSprite(SpriteRenderer* spr) {
+        if (isFull()) { return 0; }
 
-        // allocate space for the vertices
-        glGenBuffers(1, &vboID);
-        glBindBuffer(GL_ARRAY_BUFFER, vboID);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_DYNAMIC_DRAW);
+        // find the sprite's group (add the texture if we don't already have it)
+        int g = MAX_TEXTURES;
+        Texture* tex = spr->sprite.texture;
 
-        // * ------ Generate the Indices ------
+        if (tex) {
+            int free = -1;
 
-        unsigned int indices[MAX_RENDER_INDICES_LIST_SIZE];
-        int offset = 0;
-        for (int i = 0; i < MAX_RENDER_INDICES_LIST_SIZE; i += 6) {
-            indices[i] = offset;
-            indices[i + 1] = offset + 1;
-            indices[i + 2] = offset + 2;
-            
-            indices[i + 3] = offset + 2;
-            indices[i + 4] = offset + 3;
-            indices[i + 5] = offset;
-
-            offset += 4;
-        }
-
-        // * ----------------------------------
-
-        glGenBuffers(1, &eboID);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eboID);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-        glVertexAttribPointer(0, 2, GL_FLOAT, 0, VERTEX_SIZE_BYTES, (void*) 0);
-        glVertexAttribPointer(1, 4, GL_FLOAT, 0, VERTEX_SIZE_BYTES, (void*) COLOR_OFFSET);
-        glVertexAttribPointer(2, 2, GL_FLOAT, 0, VERTEX_SIZE_BYTES, (void*) TEX_COORDS_OFFSET);
-        glVertexAttribPointer(3, 1, GL_FLOAT, 0, VERTEX_SIZE_BYTES, (void*) TEX_ID_OFFSET);
-        glVertexAttribPointer(4, 1, GL_FLOAT, 0, VERTEX_SIZE_BYTES, (void*) ENTITY_ID_OFFSET);
-        glEnableVertexAttribArray(0);
-        glEnableVertexAttribArray(1);
-        glEnableVertexAttribArray(2);
-        glEnableVertexAttribArray(3);
-        glEnableVertexAttribArray(4);
-    };
+            for (g = 0; g < MAX_TEXTURES; ++g) {
+                if (textures[g] == tex) { break; }
+                if (!textures[g] && free < 0) { free = g; }
+            }
 
-    void EditorBatch::render(Shader const &currShader, Camera const &cam) {
-        bool rebuffer = 0;
+            if (g == MAX_TEXTURES) {
+                if (free < 0) { return 0; }
 
-        for (int i = 0; i < numSprites; ++i) {
-            if (sprites[i]->isDirty) {
-                loadVertexProperties(i);
-                sprites[i]->isDirty = 0;
-                rebuffer = 1;
+                g = free;
+                textures[g] = tex;
+                ++numTextures;
             }
         }
 
-        // rebuffer data if any of the sprites are dirty
-        if (rebuffer) {
-            glBindBuffer(GL_ARRAY_BUFFER, vboID);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        // the sort puts it in place on the next render
+        if (ySort) {
+            sprites[numSprites] = spr;
+            keys[numSprites] = spr->transform.pos.y;
+            slots[numSprites] = g;
+            spr->isDirty = 1;
+            ++numSprites;
+            return 1;
         }
 
-        // bind everything
-        glBindVertexArray(vaoID);
-        glEnableVertexAttribArray(0);
-        glEnableVertexAttribArray(1);
-
-        // use shader
-        currShader.use();
-        currShader.uploadMat4("uProjection", cam.proj);
-        currShader.uploadMat4("uView", cam.view);
-
-        // bind textures
-        for (int i = 0; i < numTextures; ++i) {
-            glActiveTexture(GL_TEXTURE0 + i);
-            textures[i]->bind();
+        // make a hole at the end of the sprite's group by moving the first sprite of each later group to its end
+        int hole = numSprites;
+        for (int h = NUM_GROUPS - 1; h > g; --h) {
+            int first = groupEnd[h - 1];
+            if (first != groupEnd[h]) { move(first, hole); }
+            hole = first;
+            ++groupEnd[h];
         }
 
-        currShader.uploadIntArr("uTexture", TexSlots::texSlots, 16);
-
-        glDrawElements(GL_TRIANGLES, 6*numSprites, GL_UNSIGNED_INT, 0);
-
-        currShader.detach();
-
-        // unbind everything
-        glDisableVertexAttribArray(0);
-        glDisableVertexAttribArray(1);
-        glBindVertexArray(0);
+        sprites[hole] = spr;
+        spr->isDirty = 1;
+        ++groupEnd[g];
+        ++numSprites;
+        return 1;
     };
 
-     bool EditorBatch::destroyIfExists(SpriteRenderer* spr) {
-        for (int i = 0; i < numSprites; ++i) {
-            if (sprites[i] == spr) {
-                for (int j = i; j < numSprites - 1; ++j) {
-                    sprites[j] = sprites[j + 1];
-                    sprites[j]->isDirty = 1;
-                }
-
-                numSprites--;
-                return 1;
-            }
+    template <typename Traits>
+    void Batch<Traits>::sortByY() {
+        for (int i = 0; i < numSprites; ++i) { keys[i] = sprites[i]->transform.pos.y; }
+
+        // insertion sort (close to linear since sprites rarely pass each other between frames)
+        for (int i = 1; i < numSprites; ++i) {
+            float key = keys[i];
+            if (!(key < keys[i - 1])) { continue; } // already in order
+
+            SpriteRenderer* spr = sprites[i];
+            unsigned char slot = slots[i];
+            int j = i;
+
+            // every sprite shifted over has a new spot so its quad has to be rewritten
+            do {
+                move(j - 1, j);
+                keys[j] = keys[j - 1];
+                slots[j] = slots[j - 1];
+                --j;
+            } while (j > 0 && key < keys[j - 1]);
+
+            sprites[j] = spr;
+            keys[j] = key;
+            slots[j] = slot;
+            spr->isDirty = 1;
         }
-
-        return 0;
     };
 
-    void EditorBatch::addSprite(SpriteRenderer* spr) {
-        if (numSprites < MAX_RENDER_BATCH_SIZE) {
-            sprites[numSprites] = spr;
-            sprites[numSprites]->isDirty = 1;
+    template <typename Traits>
+    void Batch<Traits>::setYSort(bool ySort) {
+        if (this->ySort == ySort) { return; }
 
-            // add texture if the sprite has a texture and we don't already have that texture
-            // ensure it is within the max number of textures, too (tbh I think the setup I have for the textures is wrong)
-            if (spr->sprite.texture && numTextures < MAX_TEXTURES) {
-                for (int i = 0; i < numTextures; ++i) { if (textures[i] == spr->sprite.texture) { goto ADDED; }}
-                textures[numTextures++] = spr->sprite.texture;
+        // take every sprite out and add them back in the new layout
+        SpriteRenderer** old = new SpriteRenderer*[numSprites];
+        int n = numSprites;
+        for (int i = 0; i < n; ++i) { old[i] = sprites[i]; }
 
-            } else if (numTextures >= MAX_TEXTURES) { // todo will remove the logging stuff but this is useful for debugging
-                std::cout << "[INFO] Maximum number of textures reached.\n";
-            }
+        for (int i = 0; i < MAX_TEXTURES; ++i) { textures[i] = nullptr; }
+        for (int i = 0; i < NUM_GROUPS; ++i) { groupEnd[i] = 0; }
+        numSprites = 0;
+        numTextures = 0;
 
-            ADDED:
-            ++numSprites;
+        this->ySort = ySort;
+
+        if (ySort) {
+            keys = new float[Traits::capacity];
+            slots = new unsigned char[Traits::capacity];
+
+        } else {
+            delete[] keys;
+            delete[] slots;
+            keys = nullptr;
+            slots = nullptr;
         }
+
+        for (int i = 0; i < n; ++i) { addSprite(old[i]); } // these always fit since they fit before
+        delete[] old;
     };
 
-    bool EditorBatch::hasTexture(Texture* tex) const {
+    template <typename Traits>
+    bool Batch<Traits>::hasTexture(Texture* tex) const {
         if (!tex) { return 0; }
-        for (int i = 0; i < numTextures; ++i) { if (textures[i] == tex) { return 1; }}
+        for (int i = 0; i < MAX_TEXTURES; ++i) { if (textures[i] == tex) { return 1; }}
         return 0;
     };
 
+    template class Batch<DynamicBatchTraits>;
+    template class Batch<EditorBatchTraits>;
+
     // * ===============================================
-    // * Renderer Stuff
+    // * LayeredBatches Stuff
 
-    void Renderer::addBatch(int n) {
+    template <typename Traits>
+    void LayeredBatches<Traits>::addBatch(int n) {
         // determine the spot to put the index in using a modified binary search
         int min = 0, max = numIndices;
         int index = numIndices/2;
@@ -645,82 +573,122 @@ namespace Dralgeer {
         ++numIndices;
     };
 
-    void Renderer::add(SpriteRenderer* spr) {
+    template <typename Traits>
+    void LayeredBatches<Traits>::addToLayer(int n, SpriteRenderer* spr) {
+        Texture* tex = spr->sprite.texture;
+        Batch<Traits>* open = nullptr; // first batch with room for the sprite
+        Batch<Traits>* last = nullptr;
+
+        // prefer a batch that already has the texture so the layer's textures stay together
+        for (Batch<Traits>* b = &batches[n]; b; b = b->next) {
+            if (tex && !b->isFull() && b->hasTexture(tex)) {
+                open = b;
+                break;
+            }
+
+            if (!open && b->canAdd(tex)) { open = b; }
+            last = b;
+        }
+
+        // every batch in the layer is full so spill into a new one
+        if (!open) {
+            open = new Batch<Traits>();
+            open->setYSort(ySorted[n]);
+            last->next = open;
+        }
+
+        open->start();
+        open->addSprite(spr);
+        ++layerSizes[n];
+    };
+
+    template <typename Traits>
+    void LayeredBatches<Traits>::add(SpriteRenderer* spr) {
         if (!spr || spr->transform.zIndex < -499 || spr->transform.zIndex > 500) { return; } // todo use an appropriate logger message when I fix that
 
         int n = spr->transform.zIndex + 499;
-        if (batches[n].numSprites >= MAX_RENDER_BATCH_SIZE) { return; } // todo use an info message here
 
         if (numIndices == 0) {
             indices[numIndices++] = n;
             batches[n].start();
-            batches[n].addSprite(spr);
+            addToLayer(n, spr);
             return;
         }
 
-        if (batches[n].numSprites == 0) { addBatch(n); }
-        batches[n].addSprite(spr);
+        if (layerSizes[n] == 0) { addBatch(n); }
+        addToLayer(n, spr);
     };
 
-    bool Renderer::destroy(SpriteRenderer* spr) {
+    template <typename Traits>
+    bool LayeredBatches<Traits>::destroy(SpriteRenderer* spr) {
         for (int i = 0; i < numIndices; ++i) {
-            if (batches[indices[i]].destroyIfExists(spr)) {
-                if (batches[indices[i]].numSprites == 0) {
-                    for (int j = i; j < numIndices - 1; ++j) { indices[j] = indices[j + 1]; }
-                    --numIndices;
-                }
+            int n = indices[i];
 
-                return 1;
+            for (Batch<Traits>* b = &batches[n]; b; b = b->next) {
+                if (b->destroyIfExists(spr)) {
+                    if (--layerSizes[n] == 0) {
+                        for (int j = i; j < numIndices - 1; ++j) { indices[j] = indices[j + 1]; }
+                        --numIndices;
+                    }
+
+                    return 1;
+                }
             }
         }
 
         return 0;
     };
 
-    void Renderer::updateZIndex(SpriteRenderer* spr) {
-        if (!destroy(spr)) { return; }
+    template <typename Traits>
+    void LayeredBatches<Traits>::render(Shader const &currShader) {
+        bool offset = 0; // the last layer drawn left its offset in the shader
 
-        // add the sprite to the new batch it belongs to
-        int n = spr->transform.zIndex + 499;
-        if (batches[n].numSprites == 0) { addBatch(n); }
-        batches[n].addSprite(spr);
-    };
+        for (int i = 0; i < numIndices; ++i) {
+            Parallax const &p = parallax[indices[i]];
+            bool isDefault = p.isDefault();
 
-    // * ===============================================
-    // * EditorRenderer Stuff
+            if (!isDefault || offset) {
+                currShader.uploadVec2("uScrollLag", glm::vec2(1.0f - p.factor.x, 1.0f - p.factor.y));
+                currShader.uploadVec2("uRepeat", p.repeat);
+                offset = !isDefault;
+            }
 
-    void EditorRenderer::addBatch(int n) {
-        // determine the spot to put the index in using a modified binary search
-        int min = 0, max = numIndices;
-        int index = numIndices/2;
+            // a repeating layer is drawn where it starts left of (or below) the view and once more right after that
+            int copiesX = p.repeat.x > 0.0f ? 2 : 1, copiesY = p.repeat.y > 0.0f ? 2 : 1;
 
-        for(;;) {
-            if (n > indices[index]) { // look through lower half
-                max = index;
-
-                if (min >= max) {
-                    for (int i = numIndices; i > min; --i) { indices[i] = indices[i - 1]; }
-                    indices[min] = n;
-                    break;
+            for (int cy = 0; cy < copiesY; ++cy) {
+                for (int cx = 0; cx < copiesX; ++cx) {
+                    if (!isDefault) { currShader.uploadVec2("uRepeatCopy", glm::vec2(cx, cy)); }
+                    for (Batch<Traits>* b = &batches[indices[i]]; b; b = b->next) { if (b->numSprites) { b->render(currShader); }}
                 }
+            }
 
-                index = (max + min)/2;
+            int numBatches = 0, numSprites = 0;
+            for (Batch<Traits>* b = &batches[indices[i]]; b; b = b->next) {
+                if (!b->numSprites) { continue; }
+                ++numBatches;
+                numSprites += b->numSprites;
+            }
 
-            } else { // look through upper half
-                min = index + 1;
+            if (numBatches) { RenderStats::countLayer(indices[i] - 499, numBatches, numSprites); }
+        }
 
-                if (min >= max) {
-                    for (int i = numIndices; i > min; --i) { indices[i] = indices[i - 1]; }
-                    indices[min] = n;
-                    break;
-                }
+        // anything else drawn with the shader stays where its vertices put it
+        if (offset) {
+            currShader.uploadVec2("uScrollLag", glm::vec2(0.0f, 0.0f));
+            currShader.uploadVec2("uRepeat", glm::vec2(0.0f, 0.0f));
+        }
+    };
 
-                index = (max + min)/2;
+    template <typename Traits>
+    void LayeredBatches<Traits>::setYSort(int zIndex, bool ySort) {
+        if (zIndex < -499 || zIndex > 500) { return; }
 
-            } // ? We do not have to consider the case that they are equal as this system guarentees that cannot happen
-        }
-        
-        batches[n].start();
-        ++numIndices;
+        int n = zIndex + 499;
+        ySorted[n] = ySort;
+        for (Batch<Traits>* b = &batches[n]; b; b = b->next) { b->setYSort(ySort); }
     };
+
+    template class LayeredBatches<DynamicBatchTraits>;
+    template class LayeredBatches<EditorBatchTraits>;
 }
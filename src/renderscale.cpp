@@ -0,0 +1,10 @@
+#include <Dralgeer/renderscale.h>
+
+namespace Dralgeer {
+    namespace RenderScale {
+        bool enabled = 1;
+        float scale = RENDER_SCALE_MAX;
+        float gpuTime = 0.0f;
+        int cooldown = 0;
+    }
+}
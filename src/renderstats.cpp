@@ -0,0 +1,120 @@
+#include <Dralgeer/renderstats.h>
+#include <mutex>
+#include <map>
+#include <utility>
+
+namespace Dralgeer {
+    namespace RenderStats {
+        FrameStats current;
+        std::atomic<long long> uploadBytes(0);
+
+        namespace {
+            FrameStats finished;
+
+            // * VRAM (made and freed from both threads).
+
+            enum ResourceKind { KIND_BUFFER, KIND_TEXTURE, KIND_RENDERBUFFER };
+
+            struct Resource {
+                long long bytes;
+                VramCategory category;
+            };
+
+            std::mutex mutex;
+            std::map<std::pair<int, unsigned int>, Resource> resources; // (kind, name) -> size
+            long long totals[NUM_VRAM_CATEGORIES] = {0};
+
+            // Resize a resource (keeping its category if it already has one).
+            inline void setSize(ResourceKind kind, unsigned int id, long long bytes, VramCategory category) {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                auto it = resources.find(std::make_pair((int) kind, id));
+                if (it == resources.end()) {
+                    resources[std::make_pair((int) kind, id)] = {bytes, category};
+                    totals[category] += bytes;
+                    return;
+                }
+
+                totals[it->second.category] += bytes - it->second.bytes;
+                it->second.bytes = bytes;
+            };
+
+            inline void free(ResourceKind kind, unsigned int id) {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                auto it = resources.find(std::make_pair((int) kind, id));
+                if (it == resources.end()) { return; }
+
+                totals[it->second.category] -= it->second.bytes;
+                resources.erase(it);
+            };
+
+            inline int bytesPerPixel(GLenum internalFormat) {
+                switch (internalFormat) {
+                    case GL_RED: case GL_R8: { return 1; }
+                    case GL_RGB: case GL_RGB8: { return 3; }
+                    case GL_RGBA16F: { return 8; }
+                    case GL_RGB32F: { return 12; }
+                    case GL_RGBA32F: { return 16; }
+                    default: { return 4; } // RGBA8, depth, and depth stencil formats
+                }
+            };
+        }
+
+        void countLayer(int zIndex, int batches, int sprites) {
+            for (int i = 0; i < current.numLayers; ++i) { if (current.layers[i].zIndex == zIndex) { return; }}
+            if (current.numLayers == RENDER_STATS_MAX_LAYERS) { return; }
+
+            current.layers[current.numLayers++] = {zIndex, batches, sprites};
+        };
+
+        FrameStats const& endFrame(int textureBinds, float gpuTime) {
+            current.bytesUploaded = uploadBytes.exchange(0, std::memory_order_relaxed);
+            current.textureBinds = textureBinds;
+            current.gpuTime = gpuTime;
+
+            finished = current;
+            current = FrameStats();
+            return finished;
+        };
+
+        // * ====================================================
+        // * VRAM Stuff
+
+        long long textureBytes(GLenum internalFormat, int width, int height, int levels) {
+            long long bytes = 0, bpp = bytesPerPixel(internalFormat);
+
+            for (int i = 0; i < levels; ++i) {
+                bytes += bpp * width * height;
+                width = width > 1 ? width/2 : 1;
+                height = height > 1 ? height/2 : 1;
+            }
+
+            return bytes;
+        };
+
+        void setBufferSize(unsigned int id, long long bytes) { setSize(KIND_BUFFER, id, bytes, VRAM_BUFFERS); };
+        void setTextureSize(unsigned int id, long long bytes) { setSize(KIND_TEXTURE, id, bytes, VRAM_TEXTURES); };
+        void setRenderbufferSize(unsigned int id, long long bytes) { setSize(KIND_RENDERBUFFER, id, bytes, VRAM_TARGETS); };
+
+        void markTarget(unsigned int texID) {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            Resource &r = resources[std::make_pair((int) KIND_TEXTURE, texID)]; // attaching before giving it storage starts it at 0 bytes
+            if (r.category == VRAM_TARGETS) { return; }
+
+            totals[r.category] -= r.bytes;
+            totals[VRAM_TARGETS] += r.bytes;
+            r.category = VRAM_TARGETS;
+        };
+
+        void freeBuffer(unsigned int id) { free(KIND_BUFFER, id); };
+        void freeTexture(unsigned int id) { free(KIND_TEXTURE, id); };
+        void freeRenderbuffer(unsigned int id) { free(KIND_RENDERBUFFER, id); };
+
+        long long vram(VramCategory category) {
+            std::lock_guard<std::mutex> lock(mutex);
+            return totals[category];
+        };
+    }
+}
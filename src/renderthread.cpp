@@ -0,0 +1,409 @@
+#include <Dralgeer/renderthread.h>
+#include <Dralgeer/assetpool.h>
+
+namespace Dralgeer {
+    // * ===============================================
+    // * RenderSnapshot Stuff
+
+    void RenderSnapshot::record(SpriteCommandType type, SpriteRenderer* spr) {
+        if (numCommands == capacity) {
+            capacity = capacity ? 2*capacity : RENDER_SNAPSHOT_START_CAPACITY;
+            SpriteCommand* temp = new SpriteCommand[capacity];
+            for (int i = 0; i < numCommands; ++i) { temp[i] = commands[i]; }
+
+            delete[] commands;
+            commands = temp;
+        }
+
+        commands[numCommands].type = type;
+        commands[numCommands].key = spr;
+        if (type != SPRITE_REMOVE) { commands[numCommands].state = *spr; }
+        ++numCommands;
+
+        spr->isDirty = 0;
+    };
+
+    void RenderSnapshot::captureDebugLines() {
+        // the persistent lines are copied every frame so the render thread always has them if it has to reallocate its VBO
+        // they are still only reuploaded to the GPU when they change
+        if (DebugDraw::numLines > persistentCapacity) {
+            while (persistentCapacity < DebugDraw::numLines) { persistentCapacity = persistentCapacity ? 2*persistentCapacity : DEBUG_START_CAPACITY; }
+            delete[] persistentLines;
+            persistentLines = new float[persistentCapacity * DEBUG_LINE_SIZE];
+        }
+
+        if (DebugDraw::numTransient > transientCapacity) {
+            while (transientCapacity < DebugDraw::numTransient) { transientCapacity = transientCapacity ? 2*transientCapacity : DEBUG_START_CAPACITY; }
+            delete[] transientLines;
+            transientLines = new float[transientCapacity * DEBUG_LINE_SIZE];
+        }
+
+        numPersistent = DebugDraw::numLines;
+        numTransient = DebugDraw::numTransient;
+        rebufferLines = DebugDraw::rebuffer;
+
+        std::memcpy(persistentLines, DebugDraw::pVertices, numPersistent * DEBUG_LINE_SIZE_BYTES);
+        std::memcpy(transientLines, DebugDraw::tVertices, numTransient * DEBUG_LINE_SIZE_BYTES);
+
+        DebugDraw::rebuffer = 0;
+        DebugDraw::numTransient = 0;
+    };
+
+    void RenderSnapshot::captureLights() {
+        lighting = Lighting::enabled;
+        lightsChanged = Lighting::dirty;
+        ambient = Lighting::ambient;
+        Lighting::dirty = 0;
+
+        if (!lighting) { numLights = 0; return; }
+
+        if (Lighting::numLights > lightCapacity) {
+            while (lightCapacity < Lighting::numLights) { lightCapacity = lightCapacity ? 2*lightCapacity : LIGHT_START_CAPACITY; }
+            delete[] lights;
+            lights = new Lighting::PointLight[lightCapacity];
+        }
+
+        numLights = Lighting::numLights;
+        std::memcpy(lights, Lighting::lights, numLights * sizeof(Lighting::PointLight));
+    };
+
+    // * ===============================================
+    // * RenderThread Stuff
+
+    void RenderThread::init(GLFWwindow* window, FrameBuffer const &frameBuffer, PickingTexture const &pickingTexture) {
+        // the window hints used for the main window are still set so this gets a matching (hidden) context
+        context = glfwCreateWindow(1, 1, "", NULL, window);
+        if (!context) { throw std::runtime_error("[ERROR] The render thread's context failed to be created."); }
+
+        sceneTexID = frameBuffer.getTextureID();
+        sceneRboID = frameBuffer.getRenderBufferID();
+        pickingTexID = pickingTexture.getTextureID();
+        pickingDepthID = pickingTexture.getDepthTextureID();
+
+        for (int i = 0; i < 2; ++i) {
+            snapshots[i].sceneWidth = frameBuffer.getWidth();
+            snapshots[i].sceneHeight = frameBuffer.getHeight();
+            snapshots[i].targetWidth = frameBuffer.getTextureWidth();
+            snapshots[i].targetHeight = frameBuffer.getTextureHeight();
+        }
+
+        // compile every shader the render thread uses here and hand them to what draws with them so it never has to compile one
+        // ? These are not put in the AssetPool since each source file has its own copy of its maps.
+        defaultShader = loadShader("../../assets/shaders/default.glsl");
+        pickingShader = loadShader("../../assets/shaders/pickingShader.glsl");
+        lineShader = loadShader("../../assets/shaders/debugLine2D.glsl");
+        gridShader = loadShader("../../assets/shaders/grid.glsl");
+        lightingShader = loadShader("../../assets/shaders/lighting.glsl");
+        particleShader = loadShader("../../assets/shaders/particle.glsl");
+
+        // make sure everything created so far is visible to the render thread's context
+        glFinish();
+
+        running = 1;
+        thread = std::thread(&RenderThread::loop, this);
+    };
+
+    void RenderThread::clearSprites() {
+        for (auto const &proxy : proxies) {
+            renderer->destroy(proxy.second);
+            delete proxy.second;
+        }
+
+        proxies.clear();
+    };
+
+    void RenderThread::apply(RenderSnapshot &snap) {
+        if (snap.clear) { clearSprites(); }
+
+        if (snap.layersChanged) {
+            for (int i = 0; i < MAX_RENDER_BATCHES; ++i) {
+                renderer->setYSort(i - 499, snap.ySortLayers[i]);
+                renderer->setParallax(i - 499, snap.parallaxLayers[i]);
+            }
+        }
+
+        for (int i = 0; i < snap.numCommands; ++i) {
+            SpriteCommand const &cmd = snap.commands[i];
+            auto proxy = proxies.find(cmd.key);
+
+            switch(cmd.type) {
+                case SPRITE_ADD: {
+                    if (proxy != proxies.end()) { goto UPDATE; } // already added so treat it as an update
+
+                    SpriteRenderer* spr = new SpriteRenderer(cmd.state);
+                    proxies.insert({cmd.key, spr});
+                    renderer->add(spr);
+                    break;
+                }
+
+                case SPRITE_UPDATE: {
+                    if (proxy == proxies.end()) { break; }
+
+                    UPDATE:
+                    int zIndex = proxy->second->transform.zIndex;
+                    Texture* texture = proxy->second->sprite.texture;
+                    *(proxy->second) = cmd.state;
+                    proxy->second->isDirty = 1;
+
+                    if (zIndex != proxy->second->transform.zIndex) { renderer->updateZIndex(proxy->second); }
+                    else if (texture != proxy->second->sprite.texture) { renderer->updateTexture(proxy->second); }
+                    break;
+                }
+
+                case SPRITE_REMOVE: {
+                    if (proxy == proxies.end()) { break; }
+
+                    renderer->destroy(proxy->second);
+                    delete proxy->second;
+                    proxies.erase(proxy);
+                    break;
+                }
+            }
+        }
+    };
+
+    bool RenderThread::attachScene() {
+        // reallocating a texture or render buffer in another context is only guaranteed to show up here once they are reattached
+        glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, sceneTexID, 0);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, sceneRboID);
+
+        // throwing here would take down the whole program so the scene is just not drawn until it is reattached
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cout << "[ERROR] Render thread's framebuffer is not complete. The scene will not be drawn.\n";
+            return 0;
+        }
+
+        return 1;
+    };
+
+    void RenderThread::draw(RenderSnapshot &snap) {
+        Animation::time = snap.time;
+        GLState::setCamera(snap.camera); // every pass this frame reads the camera from here
+
+        // reallocating the scene's attachments in another context is only seen here once they are reattached
+        if (snap.targetWidth != targetWidth || snap.targetHeight != targetHeight) {
+            sceneComplete = attachScene();
+            targetWidth = snap.targetWidth;
+            targetHeight = snap.targetHeight;
+        }
+
+        // * ------ Targets ------
+
+        int mapWidth, mapHeight;
+        Lighting::mapSize(snap.sceneWidth, snap.sceneHeight, mapWidth, mapHeight);
+
+        int lightMap = graph.transient("Light Map", mapWidth, mapHeight, GL_RGBA16F);
+        int picking = graph.import("Picking", pickingFBO, pickingTexID, 1920, 1080, snap.picking && pickingComplete);
+        int scene = graph.import("Scene", sceneFBO, sceneTexID, snap.sceneWidth, snap.sceneHeight, snap.sceneVisible && sceneComplete);
+
+        // * ------ Passes ------
+        // ? The light map is only drawn if the scene pass is, so it is left off until the lighting pass actually runs.
+
+        Lighting::skip();
+        Discovery::use(snap.fog, snap.fogOrigin, snap.fogSize, snap.fogColor);
+
+        if (snap.lighting) {
+            graph.addPass("Lighting", [this, &snap, lightMap, mapWidth, mapHeight] {
+                Lighting::render(snap.lights, snap.numLights, snap.ambient, snap.camera, snap.sceneWidth, snap.sceneHeight,
+                        graph.getTexture(lightMap), mapWidth, mapHeight);
+            }).write(lightMap);
+        }
+
+        graph.addPass("Picking", [this] {
+            glDisable(GL_BLEND);
+            renderer->render(*pickingShader);
+            glEnable(GL_BLEND);
+        }).write(picking, GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT, 0.0f, 0.0f, 0.0f, 1.0f);
+
+        FramePass &scenePass = graph.addPass("Scene", [this, &snap] {
+            glEnable(GL_BLEND); // set here since the passes before it can be culled
+            glEnable(GL_DEPTH_TEST);
+
+            if (snap.renderGrid) { gridLines->render(); }
+
+            // default.glsl outputs premultiplied alpha so additive materials can be drawn in the same batch as everything else
+            glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            renderer->render(*defaultShader);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+            Particles::draw(snap.particleDraws, snap.numParticleDraws);
+
+            // debug lines (like the physics overlay) go over everything else
+            glDisable(GL_DEPTH_TEST);
+            DebugDraw::drawLines(snap.persistentLines, snap.numPersistent, snap.rebufferLines, snap.transientLines, snap.numTransient);
+        }).write(scene, GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT, 0.1f, 0.1f, 0.1f, 1.0f);
+
+        if (snap.lighting) { scenePass.read(lightMap); }
+
+        graph.execute();
+        GLState::endFrame();
+        GLDebug::endFrame();
+    };
+
+    void RenderThread::loop() {
+        glfwMakeContextCurrent(context);
+        GLDebug::init(); // the callback belongs to the context
+
+        // * ------ Create the thread's own GL objects ------
+        // ? FBOs and VAOs are not shared between contexts so they must be made here.
+
+        glGenFramebuffers(1, &sceneFBO);
+        sceneComplete = attachScene();
+
+        glGenFramebuffers(1, &pickingFBO);
+        glBindFramebuffer(GL_FRAMEBUFFER, pickingFBO);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, pickingTexID, 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, pickingDepthID, 0);
+        glReadBuffer(GL_NONE);
+        glDrawBuffer(GL_COLOR_ATTACHMENT0);
+
+        pickingComplete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        if (!pickingComplete) { std::cout << "[ERROR] Render thread's picking framebuffer is not complete. Picking will not be drawn.\n"; }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        // context state is not shared either
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        // neither are queries
+        graph.start();
+
+        renderer = new EditorRenderer();
+        gridLines = new GridLines(gridShader);
+        DebugDraw::start(lineShader);
+        Lighting::start(lightingShader);
+        Particles::start(particleShader);
+
+        // * ------------------------------------------------
+
+        while(1) {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this] { return pending || !running; });
+            if (!running) { break; }
+
+            RenderSnapshot &snap = snapshots[front];
+            GLsync ready = submitFence;
+            submitFence = 0;
+            lock.unlock();
+
+            // wait for anything the main context did to the shared objects this frame
+            if (ready) {
+                glWaitSync(ready, 0, GL_TIMEOUT_IGNORED);
+                glDeleteSync(ready);
+            }
+
+            apply(snap);
+            draw(snap);
+
+            GLsync done = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            glFlush(); // the fence must reach the GPU before another context can wait on it
+
+            RenderStats::FrameStats const &frame = RenderStats::endFrame(GLState::state.lastFrame.textureBinds, graph.gpuTime);
+
+            lock.lock();
+            doneFence = done;
+            stats = GLState::state.lastFrame;
+            #ifdef DRALGEER_GL_DEBUG
+                calls = GLDebug::lastFrame;
+            #endif
+            gpuTime = graph.gpuTime;
+            numPassTimings = graph.numTimings;
+            std::memcpy(passTimings, graph.timings, numPassTimings * sizeof(PassTiming));
+
+            frameStats = frame;
+            float lastGPUTime = history[(historyIndex + RENDER_STATS_HISTORY - 1) % RENDER_STATS_HISTORY].gpuTime;
+            history[historyIndex] = {(float) frame.drawCalls, frame.bytesUploaded/1024.0f, frame.gpuTime > 0.0f ? frame.gpuTime : lastGPUTime};
+            historyIndex = (historyIndex + 1) % RENDER_STATS_HISTORY;
+
+            pending = 0;
+            lock.unlock();
+            cv.notify_all();
+        }
+
+        // free everything the thread made
+        clearSprites();
+        delete renderer;
+        delete gridLines;
+        DebugDraw::stop();
+        Lighting::stop();
+        Particles::stop();
+        graph.stop();
+        GLState::destroy();
+
+        glDeleteFramebuffers(1, &sceneFBO);
+        glDeleteFramebuffers(1, &pickingFBO);
+
+        glfwMakeContextCurrent(NULL);
+    };
+
+    void RenderThread::wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return !pending; });
+
+        GLsync done = doneFence;
+        doneFence = 0;
+        lock.unlock();
+
+        if (done) {
+            glWaitSync(done, 0, GL_TIMEOUT_IGNORED);
+            glDeleteSync(done);
+        }
+    };
+
+    void RenderThread::submit() {
+        RenderSnapshot &snap = snapshots[1 - front];
+        snap.time = (float) glfwGetTime();
+
+        lastCamera = snap.camera;
+        lastWidth = snap.sceneWidth;
+        lastHeight = snap.sceneHeight;
+        lastVisible = snap.sceneVisible;
+        lastPicking = snap.picking;
+
+        GLsync ready = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            front = 1 - front;
+            submitFence = ready;
+            pending = 1;
+        }
+
+        cv.notify_all();
+
+        // the render thread was done with the old front snapshot before this was called so it can be recorded into right away
+        snapshots[1 - front].reset();
+    };
+
+    void RenderThread::destroy() {
+        if (!running) { return; }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = 0;
+        }
+
+        cv.notify_all();
+        thread.join();
+
+        if (submitFence) { glDeleteSync(submitFence); }
+        if (doneFence) { glDeleteSync(doneFence); }
+        submitFence = 0;
+        doneFence = 0;
+
+        glfwDestroyWindow(context);
+        context = nullptr;
+
+        // programs are shared so they can be freed from the main context
+        delete defaultShader;
+        delete pickingShader;
+        delete lineShader;
+        delete gridShader;
+        delete lightingShader;
+        delete particleShader;
+        defaultShader = pickingShader = lineShader = gridShader = lightingShader = particleShader = nullptr;
+    };
+}
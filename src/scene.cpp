@@ -7,6 +7,7 @@
 #include <fstream>
 #include <Dralgeer/systemmessages.h>
 #include <Dralgeer/serializer.h>
+#include <Dralgeer/physicsdebug.h>
 
 // todo force gameObject positions and transforms to be uint16s
 
@@ -16,7 +17,7 @@ namespace Dralgeer {
 
     void SubScene::init(int width, int height, int capacity, SpriteRenderer** spr, int size, ZMath::Vec2D const &g, float timeStep) {
         frameBuffer.init(width, height);
-        renderer.init(spr, size);
+        renderer.init(spr, size); // built on a worker thread and uploaded over the next few frames (so spr's sprites must outlive that)
         physicsHandler = Zeta::Handler(g, timeStep);
 
         this->capacity = capacity;
@@ -26,6 +27,7 @@ namespace Dralgeer {
     void SubScene::update(float &dt) {
         camera.adjustProjection();
         physicsHandler.update(dt);
+        PhysicsDebug::draw(physicsHandler);
 
         // remove dead dynamic sprites
         for (int i = numSprites - 1; i >= 0; --i) {
@@ -48,14 +50,22 @@ namespace Dralgeer {
         if (physicsUpdate) {
             physicsHandler.update(dt);
 
+            // the player sees whatever passes through the middle of the view
+            if (Discovery::enabled) { discovery.reveal(camera.pos + camera.projSize * 0.5f, DISCOVERY_VIEW_RADIUS); }
+
         } else {
             editorCamera.update(dt, wantCapture);
-            gridLines.update(camera);
             mouseControls.update();
             gizmoSystem.update();
 
             for (int i = 0; i < numObjects; ++i) {
-                if (gameObjects[i]->sprite && gameObjects[i]->sprite->rebufferZIndex) { renderer.updateZIndex(gameObjects[i]->sprite); }
+                SpriteRenderer* spr = gameObjects[i]->sprite;
+
+                // the render thread moves the sprite to its new batch when it sees the zIndex changed
+                if (spr && spr->rebufferZIndex) {
+                    renderThread->record(SPRITE_UPDATE, spr);
+                    spr->rebufferZIndex = 0;
+                }
             }
         }
 
@@ -63,12 +73,15 @@ namespace Dralgeer {
             gameObjects[i]->update();
 
             if (gameObjects[i]->dead) {
-                renderer.destroy(gameObjects[i]->sprite);
+                if (gameObjects[i]->sprite) { renderThread->record(SPRITE_REMOVE, gameObjects[i]->sprite); }
                 delete gameObjects[i];
                 --numObjects;
                 for (int j = i; j < numObjects; ++j) { gameObjects[j] = gameObjects[j + 1]; }
             }
         }
+
+        // the colliders are shown while editing too (the contacts are only recorded or cleared when the handler steps)
+        PhysicsDebug::draw(physicsHandler);
     };
 
     inline void LevelEditorScene::loadResources() {
@@ -88,9 +101,9 @@ namespace Dralgeer {
 
     LevelEditorScene::LevelEditorScene(LevelEditorScene const &scene) {
         camera = scene.camera;
+        renderThread = scene.renderThread;
         
         editorCamera = scene.editorCamera;
-        gridLines = scene.gridLines;
         mouseControls = scene.mouseControls;
         gizmoSystem = scene.gizmoSystem;
 
@@ -118,9 +131,9 @@ namespace Dralgeer {
 
     LevelEditorScene::LevelEditorScene(LevelEditorScene &&scene) {
         camera = std::move(scene.camera);
+        renderThread = scene.renderThread;
         editorCamera = std::move(scene.editorCamera);
         mouseControls = std::move(scene.mouseControls);
-        gridLines = std::move(scene.gridLines);
         gizmoSystem = std::move(scene.gizmoSystem);
 
         sprites = scene.sprites;
@@ -135,9 +148,9 @@ namespace Dralgeer {
     LevelEditorScene& LevelEditorScene::operator = (LevelEditorScene const &scene) {
         if (this != &scene) {
             camera = scene.camera;
+            renderThread = scene.renderThread;
             
             editorCamera = scene.editorCamera;
-            gridLines = scene.gridLines;
             mouseControls = scene.mouseControls;
             gizmoSystem = scene.gizmoSystem;
 
@@ -180,9 +193,9 @@ namespace Dralgeer {
     LevelEditorScene& LevelEditorScene::operator = (LevelEditorScene &&scene) {
         if (this != &scene) {
             camera = std::move(scene.camera);
+            renderThread = scene.renderThread;
             editorCamera = std::move(scene.editorCamera);
             mouseControls = std::move(scene.mouseControls);
-            gridLines = std::move(scene.gridLines);
             gizmoSystem = std::move(scene.gizmoSystem);
 
             sprites = scene.sprites;
@@ -201,9 +214,50 @@ namespace Dralgeer {
     LevelEditorScene::~LevelEditorScene() {
         for (int i = 0; i < numObjects; ++i) { delete gameObjects[i]; }
         delete[] gameObjects;
+        if (Discovery::active == &discovery) { Discovery::setActive(nullptr); }
+    };
+
+    int LevelEditorScene::addDecalLayer(glm::vec2 const &origin, glm::vec2 const &size, int zIndex) {
+        if (numDecalLayers == DECAL_MAX_LAYERS) { return -1; }
+
+        DecalLayer &layer = decalLayers[numDecalLayers];
+        layer.init(origin, size, zIndex);
+        if (running) { renderThread->record(SPRITE_ADD, layer.quad); }
+
+        return numDecalLayers++;
+    };
+
+    void LevelEditorScene::capture(bool renderGrid) {
+        bool animating = 0;
+        float now = (float) glfwGetTime();
+
+        // decals stamped this frame are baked in before their layer's sprite is recorded
+        for (int i = 0; i < numDecalLayers; ++i) {
+            decalLayers[i].flush();
+            if (decalLayers[i].quad->isDirty) { renderThread->record(SPRITE_UPDATE, decalLayers[i].quad); }
+        }
+
+        for (int i = 0; i < numObjects; ++i) {
+            SpriteRenderer* spr = gameObjects[i]->sprite;
+            if (!spr) { continue; }
+
+            if (spr->isDirty) { renderThread->record(SPRITE_UPDATE, spr); }
+            if (!animating && Animation::isPlaying(spr, now)) { animating = 1; }
+        }
+
+        RenderSnapshot* snap = renderThread->back();
+        snap->animating = animating;
+        snap->camera = camera;
+        snap->renderGrid = renderGrid;
+        snap->captureDebugLines();
+        snap->captureLights();
+        snap->captureParticles();
+        snap->captureDiscovery();
     };
 
-    void LevelEditorScene::init() {
+    void LevelEditorScene::init(RenderThread* renderThread) {
+        this->renderThread = renderThread;
+
         camera.pos = glm::vec2(0.0f, 0.0f);
         camera.adjustProjection();
         camera.adjustView();
@@ -213,6 +267,10 @@ namespace Dralgeer {
         // load sprite sheet
         sprites = AssetPool::getSpriteSheet("../../assets/images/spritesheets/decorationsAndBlocks.png");
 
+        // decals are baked into a single layer over the floor
+        addDecalLayer(glm::vec2(0.0f, 0.0f), glm::vec2(DECAL_EDITOR_LAYER_SIZE, DECAL_EDITOR_LAYER_SIZE), DECAL_EDITOR_Z_INDEX);
+        discovery.init(glm::vec2(0.0f, 0.0f), DISCOVERY_CELL_SIZE, DISCOVERY_EDITOR_CELLS, DISCOVERY_EDITOR_CELLS);
+
         editorCamera.init(camera);
         gizmoSystem.init(AssetPool::getSpriteSheet("../../assets/images/gizmos.png"));
         gizmoSystem.start();
@@ -349,9 +407,20 @@ namespace Dralgeer {
         std::fstream f("../scenes/levelEditor.scene", std::ios::binary | std::ios::out | std::fstream::trunc);
         f.write(buffer, bufferSize);
         f.close();
+
+        // each decal layer's texture is saved next to the scene
+        // flushing draws into the layers so the render thread has to be done sampling them first (saving can happen mid frame)
+        if (numDecalLayers) { renderThread->wait(); }
+
+        for (int i = 0; i < numDecalLayers; ++i) {
+            decalLayers[i].flush();
+            decalLayers[i].save("../scenes/levelEditor.decals" + std::to_string(i) + ".png");
+        }
     };
 
     void LevelEditorScene::importScene() {
+        for (int i = 0; i < numDecalLayers; ++i) { decalLayers[i].load("../scenes/levelEditor.decals" + std::to_string(i) + ".png"); }
+
         // open the file to read from
         std::fstream f("../scenes/levelEditor.scene", std::ios::binary | std::ios::in);
 
@@ -0,0 +1,201 @@
+#include <Dralgeer/text.h>
+#include <fstream>
+#include <vector>
+
+// ImGui compiles its own copy of stb_truetype so keep this one private to this file
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <IMGUI/imstb_truetype.h>
+
+namespace Dralgeer {
+    // * ====================================================
+    // * Font Stuff
+
+    void Font::init(std::string const &filepath) {
+        this->filepath = filepath;
+
+        std::ifstream file(filepath, std::ios::binary);
+        if (!file) { throw std::runtime_error("[ERROR] Font '" + filepath + "' could not be opened."); }
+        std::vector<unsigned char> ttf((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        stbtt_fontinfo info;
+        if (!stbtt_InitFont(&info, ttf.data(), stbtt_GetFontOffsetForIndex(ttf.data(), 0))) {
+            throw std::runtime_error("[ERROR] Font '" + filepath + "' could not be read.");
+        }
+
+        float scale = stbtt_ScaleForPixelHeight(&info, FONT_PIXEL_HEIGHT);
+
+        int ascent, descent, lineGap;
+        stbtt_GetFontVMetrics(&info, &ascent, &descent, &lineGap);
+        lineHeight = (ascent - descent + lineGap) * scale;
+
+        // * ------ Rasterize the glyphs into the atlas ------
+        // ? The glyphs are packed in rows. Rows of the atlas are uploaded top down so the top of a glyph has the smaller v.
+
+        unsigned char* atlas = new unsigned char[FONT_ATLAS_SIZE * FONT_ATLAS_SIZE * 4];
+        for (int i = 0; i < FONT_ATLAS_SIZE * FONT_ATLAS_SIZE; ++i) {
+            atlas[4*i] = 255;
+            atlas[4*i + 1] = 255;
+            atlas[4*i + 2] = 255;
+            atlas[4*i + 3] = 0;
+        }
+
+        int x = 0, y = 0, rowHeight = 0;
+
+        for (int i = 0; i < FONT_NUM_GLYPHS; ++i) {
+            int codepoint = FONT_FIRST_CHAR + i;
+            Glyph &g = glyphs[i];
+
+            int advance, bearing;
+            stbtt_GetCodepointHMetrics(&info, codepoint, &advance, &bearing);
+            g.advance = advance * scale;
+
+            // 128 is the glyph's edge and each step of the padding is 128/padding
+            int w = 0, h = 0, xoff = 0, yoff = 0;
+            unsigned char* sdf = stbtt_GetCodepointSDF(&info, scale, codepoint, FONT_SDF_PADDING, 128, 128.0f/FONT_SDF_PADDING, &w, &h, &xoff, &yoff);
+
+            if (!sdf) { // nothing to draw (e.g. a space)
+                g.offset = glm::vec2(0.0f, 0.0f);
+                g.size = glm::vec2(0.0f, 0.0f);
+                for (int j = 0; j < 4; ++j) { g.texCoords[j] = glm::vec2(0.0f, 0.0f); }
+                continue;
+            }
+
+            // start a new row if the glyph does not fit on this one (1 pixel of space keeps filtering from bleeding between glyphs)
+            if (x + w > FONT_ATLAS_SIZE) {
+                x = 0;
+                y += rowHeight + 1;
+                rowHeight = 0;
+            }
+
+            if (y + h > FONT_ATLAS_SIZE) {
+                stbtt_FreeSDF(sdf, NULL);
+                delete[] atlas;
+                throw std::runtime_error("[ERROR] Font '" + filepath + "' does not fit in its atlas.");
+            }
+
+            for (int row = 0; row < h; ++row) {
+                for (int col = 0; col < w; ++col) { atlas[4*((y + row)*FONT_ATLAS_SIZE + x + col) + 3] = sdf[row*w + col]; }
+            }
+
+            stbtt_FreeSDF(sdf, NULL);
+
+            // stb_truetype measures y downwards from the baseline
+            g.offset = glm::vec2(xoff, -(yoff + h));
+            g.size = glm::vec2(w, h);
+
+            float left = x/((float) FONT_ATLAS_SIZE), right = (x + w)/((float) FONT_ATLAS_SIZE);
+            float top = y/((float) FONT_ATLAS_SIZE), bottom = (y + h)/((float) FONT_ATLAS_SIZE);
+
+            g.texCoords[0] = glm::vec2(right, top);
+            g.texCoords[1] = glm::vec2(right, bottom);
+            g.texCoords[2] = glm::vec2(left, bottom);
+            g.texCoords[3] = glm::vec2(left, top);
+
+            x += w + 1;
+            if (h > rowHeight) { rowHeight = h; }
+        }
+
+        // kerning is cached for every pair so laying out text never has to touch the font file
+        for (int i = 0; i < FONT_NUM_GLYPHS; ++i) {
+            for (int j = 0; j < FONT_NUM_GLYPHS; ++j) {
+                kerning[i*FONT_NUM_GLYPHS + j] = stbtt_GetCodepointKernAdvance(&info, FONT_FIRST_CHAR + i, FONT_FIRST_CHAR + j) * scale;
+            }
+        }
+
+        // * ------ Upload the atlas ------
+
+        texture = new Texture();
+        texture->init(FONT_ATLAS_SIZE, FONT_ATLAS_SIZE);
+        texture->filepath = filepath;
+        texture->sdf = 1;
+
+        GPU::textureParameter(texture->texID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        GPU::textureParameter(texture->texID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        GPU::textureSubImage2D(texture->texID, 0, 0, FONT_ATLAS_SIZE, FONT_ATLAS_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, atlas);
+
+        delete[] atlas;
+    };
+
+    // * ====================================================
+    // * Text Stuff
+
+    void Text::init(Font* font, int maxLength, glm::vec2 const &pos, float size, int zIndex) {
+        this->font = font;
+        this->maxLength = maxLength;
+        this->pos = pos;
+        this->size = size;
+        this->zIndex = zIndex;
+
+        glyphs = new SpriteRenderer*[maxLength];
+
+        for (int i = 0; i < maxLength; ++i) {
+            SpriteRenderer* spr = new SpriteRenderer();
+            spr->sprite.texture = font->texture;
+            spr->color = color;
+            spr->transform.pos = pos;
+            spr->transform.scale = glm::vec2(0.0f, 0.0f); // collapsed until it is used
+            spr->transform.zIndex = zIndex;
+            spr->start();
+            glyphs[i] = spr;
+        }
+    };
+
+    void Text::layout() {
+        float scale = size/font->lineHeight;
+        glm::vec2 pen = pos;
+        char prev = 0;
+        int n = 0;
+
+        // place each glyph and only dirty the ones that actually moved
+        for (char c : str) {
+            if (n == maxLength) { break; }
+
+            if (c == '\n') {
+                pen.x = pos.x;
+                pen.y -= size;
+                prev = 0;
+                continue;
+            }
+
+            Glyph const* g = font->getGlyph(c);
+            if (!g) { prev = 0; continue; }
+
+            if (prev) { pen.x += font->getKerning(prev, c) * scale; }
+            prev = c;
+
+            if (g->size.x > 0.0f) {
+                SpriteRenderer* spr = glyphs[n++];
+                spr->transform.pos = pen + g->offset * scale;
+                spr->transform.scale = g->size * scale;
+
+                for (int i = 0; i < 4; ++i) {
+                    if (spr->sprite.texCoords[i] != g->texCoords[i]) {
+                        spr->sprite.texCoords[i] = g->texCoords[i];
+                        spr->isDirty = 1;
+                    }
+                }
+
+                spr->update();
+            }
+
+            pen.x += g->advance * scale;
+        }
+
+        // collapse whatever is left over
+        for (; n < maxLength; ++n) {
+            glyphs[n]->transform.scale = glm::vec2(0.0f, 0.0f);
+            glyphs[n]->update();
+        }
+    };
+
+    void Text::setColor(glm::vec4 const &color) {
+        if (this->color == color) { return; }
+        this->color = color;
+
+        for (int i = 0; i < maxLength; ++i) {
+            glyphs[i]->color = color;
+            glyphs[i]->isDirty = 1;
+        }
+    };
+}
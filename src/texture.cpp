@@ -1,6 +1,8 @@
 #define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <Dralgeer/texture.h>
 #include <STB/stb_image.h>
+#include <STB/stb_image_write.h>
 
 namespace Dralgeer {
     // * =================================================================================================================
@@ -131,7 +133,38 @@ namespace Dralgeer {
 
             glDeleteProgram(shaderID);
             delete[] errorLog;
+            return;
         }
+
+        // * ------ Resolve Uniforms ------
+
+        // every shader reads the camera from the same UBO
+        unsigned int cameraBlock = glGetUniformBlockIndex(shaderID, "Camera");
+        if (cameraBlock != GL_INVALID_INDEX) { glUniformBlockBinding(shaderID, cameraBlock, CAMERA_UBO_BINDING); }
+
+        // cache the location of each uniform so uploading one never has to ask the driver
+        int numUniforms = 0, maxLen = 0;
+        glGetProgramiv(shaderID, GL_ACTIVE_UNIFORMS, &numUniforms);
+        glGetProgramiv(shaderID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLen);
+
+        char* name = new char[maxLen];
+        uniforms.clear();
+
+        for (int i = 0; i < numUniforms; ++i) {
+            int len = 0, size = 0;
+            GLenum type;
+            glGetActiveUniform(shaderID, i, maxLen, &len, &size, &type, name);
+
+            int loc = glGetUniformLocation(shaderID, name);
+            if (loc < 0) { continue; } // uniforms inside of blocks do not have a location
+
+            // arrays are reported as "name[0]" but uploaded to with just their name
+            std::string uniform(name, len);
+            if (uniform.size() > 3 && uniform.compare(uniform.size() - 3, 3, "[0]") == 0) { uniform.resize(uniform.size() - 3); }
+            uniforms[uniform] = loc;
+        }
+
+        delete[] name;
     };
 
 
@@ -142,16 +175,11 @@ namespace Dralgeer {
         this->filepath = filepath;
 
         // generate texture on the GPU
-        glGenTextures(1, &texID);
-        glBindTexture(GL_TEXTURE_2D, texID);
-        // * set texture parameters
-        // repeat the image in both directions
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        texID = GPU::createTexture2D();
 
-        // when stretching or shriking the image, pixelate
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        // * set texture parameters
+        // repeat the image in both directions and pixelate when stretching or shrinking it
+        GPU::textureSampling(texID, GL_NEAREST, GL_REPEAT);
 
         // * load the image
         int channels;
@@ -159,16 +187,20 @@ namespace Dralgeer {
         unsigned char* image = stbi_load(filepath.c_str(), &width, &height, &channels, 0);
 
         if (image) {
+            // images are never resized so their storage is immutable (with room for every mip level)
+            int levels = 1;
+            for (int size = width > height ? width : height; size > 1; size >>= 1) { ++levels; }
+
             // upload image to the GPU
             if (channels == 3) { // RGB
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
-                glGenerateMipmap(GL_TEXTURE_2D);
+                GPU::storeTexture2D(texID, GL_RGB8, levels, width, height, GL_RGB, GL_UNSIGNED_BYTE, image);
+                GPU::generateMipmap(texID);
 
             } else if (channels == 4) { // RGBA
                 // std::cout << filepath << "\n";
                 
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-                glGenerateMipmap(GL_TEXTURE_2D);
+                GPU::storeTexture2D(texID, GL_RGBA8, levels, width, height, GL_RGBA, GL_UNSIGNED_BYTE, image);
+                GPU::generateMipmap(texID);
 
             } else {
                 stbi_image_free(image);
@@ -189,14 +221,14 @@ namespace Dralgeer {
         filepath = "generated";
 
         // generate texture on the GPU
-        glGenTextures(1, &texID);
-        glBindTexture(GL_TEXTURE_2D, texID);
+        texID = GPU::createTexture2D();
 
         // define the type of interpolation when stretching or shrinking the image (linear)
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        GPU::textureParameter(texID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        GPU::textureParameter(texID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+        // generated textures can be resized (e.g. the scene's framebuffer) so their storage is mutable
+        GPU::allocateTexture2D(texID, GL_RGBA, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
     };
 
     // * =================================================================================================================
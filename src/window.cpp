@@ -10,7 +10,11 @@ namespace Dralgeer {
         ImGuiLayer imGuiLayer;
         FrameBuffer frameBuffer;
         PickingTexture* pickingTexture;
+        RenderThread renderThread;
 
         bool runtimePlaying = 0;
+
+        bool idleEnabled = 1;
+        std::atomic<int> activeFrames(IDLE_GRACE_FRAMES);
     }
 }